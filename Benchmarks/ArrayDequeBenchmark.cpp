@@ -0,0 +1,209 @@
+#include <vector>
+#include "../Cpp/MyArrayDeque.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr int SIZES[] = { 16, 1'000, 100'000 };
+		constexpr int OPERATIONS = 20'000'000;
+		constexpr int FILL_ITEMS = 1 << 24;
+		constexpr int BATCH_SIZES[] = { 1, 8, 32, 64, 128, 256 };
+		constexpr int BATCH_ITEMS = 20'000'000;
+		constexpr int BATCH_BACKLOG = 1'000; //held throughout so the batches keep crossing the wrap
+
+		struct Packet
+		{
+			uint64_t words[4];
+		};
+
+		//the original MyArrayDeque ring, any capacity, with a modulo on every access and front_/back_ left to drift,
+		//kept here only as the baseline the masked ring is measured against
+		template<typename Type>
+		class ModuloArrayDeque
+		{
+			Type* array_ = new Type[4];
+			int capacity_ = 4;
+			int front_ = 0;
+			int back_ = 0;
+			int count_ = 0;
+
+			void ensure_capacity()
+			{
+				if (count_ <= capacity_) return;
+				const int new_capacity = capacity_ * 2;
+				Type* copy = new Type[new_capacity];
+				for (int index = 0; index < capacity_; index++)
+				{
+					copy[index] = array_[(front_ + index + capacity_) % capacity_];
+				}
+				back_ -= front_;
+				front_ = 0;
+				delete[] array_;
+				array_ = copy;
+				capacity_ = new_capacity;
+			}
+			int last_index() const { return (back_ + capacity_) % capacity_; }
+			int first_index() const { return (front_ + capacity_) % capacity_; }
+
+		public:
+			ModuloArrayDeque() = default;
+			ModuloArrayDeque(const ModuloArrayDeque&) = delete;
+			~ModuloArrayDeque() { delete[] array_; }
+
+			void add_last(const Type& data)
+			{
+				if (count_ != 0) ++back_;
+				++count_;
+				ensure_capacity();
+				Type copy = data;
+				array_[last_index()] = copy;
+			}
+			const Type& remove_last()
+			{
+				if (count_ == 0) throw std::exception("empty deque");
+				const Type& result = array_[last_index()];
+				if (count_ != 1) --back_;
+				--count_;
+				return result;
+			}
+
+			void add_first(const Type& data)
+			{
+				if (count_ != 0) --front_;
+				++count_;
+				ensure_capacity();
+				Type copy = data;
+				array_[first_index()] = copy;
+			}
+			const Type& remove_first()
+			{
+				if (count_ == 0) throw std::exception("empty deque");
+				const Type& result = array_[first_index()];
+				if (count_ != 1) ++front_;
+				--count_;
+				return result;
+			}
+		};
+
+		//the deque is filled to size first, then each operation is one add and one remove, so it stays at size
+		//queue adds last and removes first, the ring turns over and every index wraps
+		//stack adds and removes last, the indices stay put
+		template<typename TDeque>
+		void measure(int size, const std::string& label)
+		{
+			TDeque deque;
+			for (int value = 0; value < size; value++)
+			{
+				deque.add_last(value);
+			}
+			uint64_t sink = 0;
+
+			Stopwatch stopwatch;
+			for (int operation = 0; operation < OPERATIONS; operation++)
+			{
+				deque.add_last(operation);
+				sink += deque.remove_first();
+			}
+			print_row(label + " queue", static_cast<double>(OPERATIONS) / stopwatch.elapsed_seconds(), "ops/s");
+
+			stopwatch.restart();
+			for (int operation = 0; operation < OPERATIONS; operation++)
+			{
+				deque.add_first(operation);
+				sink += deque.remove_last();
+			}
+			print_row(label + " queue from the front", static_cast<double>(OPERATIONS) / stopwatch.elapsed_seconds(), "ops/s");
+
+			stopwatch.restart();
+			for (int operation = 0; operation < OPERATIONS; operation++)
+			{
+				deque.add_last(operation);
+				sink += deque.remove_last();
+			}
+			print_row(label + " stack", static_cast<double>(OPERATIONS) / stopwatch.elapsed_seconds(), "ops/s");
+			if (sink == 42) std::cout << "";
+		}
+
+		//from empty, adding first so the items are wrapped every time the deque grows
+		template<typename TDeque>
+		void measure_fill(const std::string& label)
+		{
+			Stopwatch stopwatch;
+			{
+				TDeque deque;
+				for (int value = 0; value < FILL_ITEMS; value++)
+				{
+					deque.add_first(value);
+				}
+			}
+			print_row(label + " fill", static_cast<double>(FILL_ITEMS) / stopwatch.elapsed_seconds(), "ops/s");
+		}
+
+		//a producer adds batch_size packets then a consumer takes batch_size, until BATCH_ITEMS have gone through
+		//add_batch and take_batch pick how, the result is packets through per second
+		template<typename TAddBatch, typename TTakeBatch>
+		double measure_batches(int batch_size, TAddBatch add_batch, TTakeBatch take_batch)
+		{
+			MyArrayDeque<Packet> deque;
+			std::vector<Packet> in(batch_size);
+			std::vector<Packet> out(batch_size);
+			for (int index = 0; index < batch_size; index++)
+			{
+				in[index].words[0] = static_cast<uint64_t>(index);
+			}
+			for (int index = 0; index < BATCH_BACKLOG; index++)
+			{
+				deque.add_last(in[0]);
+			}
+			uint64_t sink = 0;
+
+			Stopwatch stopwatch;
+			for (int moved = 0; moved < BATCH_ITEMS; moved += batch_size)
+			{
+				add_batch(deque, in.data(), batch_size);
+				take_batch(deque, out.data(), batch_size);
+				sink += out[batch_size - 1].words[0];
+			}
+			const double seconds = stopwatch.elapsed_seconds();
+			if (sink == 42) std::cout << "";
+			return static_cast<double>(BATCH_ITEMS) / seconds;
+		}
+	}
+
+	void array_deque_benchmark()
+	{
+		for (int size : SIZES)
+		{
+			print_header("MyArrayDeque modulo vs masked ring, " + std::to_string(size) + " ints held");
+			measure<ModuloArrayDeque<int>>(size, "modulo");
+			measure<MyArrayDeque<int>>(size, "masked");
+		}
+		print_header("MyArrayDeque growth, " + std::to_string(FILL_ITEMS) + " ints added first");
+		measure_fill<ModuloArrayDeque<int>>("modulo");
+		measure_fill<MyArrayDeque<int>>("masked");
+	}
+
+	void array_deque_batch_benchmark()
+	{
+		for (int batch_size : BATCH_SIZES)
+		{
+			print_header("MyArrayDeque batches of " + std::to_string(batch_size) + " 32 byte packets");
+			print_row("one at a time", measure_batches(batch_size,
+				[](MyArrayDeque<Packet>& deque, const Packet* items, int count)
+				{
+					for (int index = 0; index < count; index++) deque.add_last(items[index]);
+				},
+				[](MyArrayDeque<Packet>& deque, Packet* out_items, int count)
+				{
+					for (int index = 0; index < count; index++) out_items[index] = deque.take_first();
+				}), "packets/s");
+			print_row("add_last_range/remove_first_n", measure_batches(batch_size,
+				[](MyArrayDeque<Packet>& deque, const Packet* items, int count) { deque.add_last_range(items, count); },
+				[](MyArrayDeque<Packet>& deque, Packet* out_items, int count) { deque.remove_first_n(out_items, count); }),
+				"packets/s");
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include "../Cpp/MyConcurrentLruCache.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr size_t CAPACITY = 1 << 16;
+		constexpr uint64_t KEY_SPACE = CAPACITY * 2;
+		constexpr int KEYS_PER_THREAD = 2'000'000;
+
+		//the same keys for every run, drawn up front so the generator isn't measured
+		std::vector<uint64_t> make_keys(int thread_index)
+		{
+			ZipfGenerator zipf(KEY_SPACE, 0.9, thread_index + 1);
+			std::vector<uint64_t> keys(KEYS_PER_THREAD);
+			for (uint64_t& key : keys)
+			{
+				key = zipf.next();
+			}
+			return keys;
+		}
+
+		double measure_keys_per_second(MyConcurrentLruCache<uint64_t, uint64_t>& cache, const std::vector<std::vector<uint64_t>>& keys_per_thread, int thread_count, size_t batch_size)
+		{
+			const double seconds = run_threads(thread_count, [&](int thread_index)
+			{
+				const std::vector<uint64_t>& keys = keys_per_thread[thread_index];
+				uint64_t sink = 0;
+				if (batch_size == 1)
+				{
+					for (uint64_t key : keys)
+					{
+						cache.try_get(key, sink);
+					}
+					return;
+				}
+
+				std::vector<uint64_t> batch;
+				std::vector<uint64_t> values;
+				std::vector<bool> found;
+				for (size_t start = 0; start < keys.size(); start += batch_size)
+				{
+					batch.assign(keys.begin() + start, keys.begin() + std::min(keys.size(), start + batch_size));
+					cache.get_many(batch, values, found);
+				}
+			});
+			return static_cast<double>(thread_count) * KEYS_PER_THREAD / seconds;
+		}
+
+		double measure_single_threaded_keys_per_second(MyLruCache<uint64_t, uint64_t>& cache, const std::vector<uint64_t>& keys, size_t batch_size)
+		{
+			Stopwatch stopwatch;
+			uint64_t hits = 0;
+			if (batch_size == 1)
+			{
+				for (uint64_t key : keys)
+				{
+					hits += cache.try_get(key) != nullptr ? 1 : 0;
+				}
+			}
+			else
+			{
+				std::vector<uint64_t> batch;
+				std::vector<uint64_t*> values;
+				for (size_t start = 0; start < keys.size(); start += batch_size)
+				{
+					batch.assign(keys.begin() + start, keys.begin() + std::min(keys.size(), start + batch_size));
+					hits += cache.get_many(batch, values);
+				}
+			}
+			const double seconds = stopwatch.elapsed_seconds();
+			return hits == 0 ? 0 : static_cast<double>(keys.size()) / seconds;
+		}
+	}
+
+	void batch_lru_cache_benchmark()
+	{
+		const size_t batch_sizes[] = { 1, 50, 500 };
+		const int max_threads = thread_counts().back();
+		std::vector<std::vector<uint64_t>> keys_per_thread;
+		for (int thread_index = 0; thread_index < max_threads; thread_index++)
+		{
+			keys_per_thread.push_back(make_keys(thread_index));
+		}
+
+		print_header("lru cache, per key get vs get_many, zipf 0.9, keys/sec");
+		for (size_t batch_size : batch_sizes)
+		{
+			MyLruCache<uint64_t, uint64_t> cache;
+			cache.set_capacity(CAPACITY);
+			for (uint64_t key = 0; key < CAPACITY; key++)
+			{
+				cache.put(key, key);
+			}
+			const std::string label = batch_size == 1 ? "per key" : "batches of " + std::to_string(batch_size);
+			print_row(label, measure_single_threaded_keys_per_second(cache, keys_per_thread[0], batch_size), "keys/s");
+		}
+
+		print_header("concurrent lru cache, per key try_get vs get_many, zipf 0.9, keys/sec");
+		for (int thread_count : thread_counts())
+		{
+			for (size_t drain_threshold : { static_cast<size_t>(0), READ_BUFFER_SIZE / 2 })
+			{
+				for (size_t batch_size : batch_sizes)
+				{
+					MyConcurrentLruCache<uint64_t, uint64_t> cache;
+					cache.set_capacity(CAPACITY);
+					cache.set_drain_threshold(drain_threshold);
+					for (uint64_t key = 0; key < CAPACITY; key++)
+					{
+						cache.put(key, key);
+					}
+					const std::string label = std::to_string(thread_count) + " thread(s)" + (drain_threshold == 0 ? " locked" : " buffered")
+						+ (batch_size == 1 ? " per key" : " x" + std::to_string(batch_size));
+					print_row(label, measure_keys_per_second(cache, keys_per_thread, thread_count, batch_size), "keys/s");
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+
+	class Stopwatch
+	{
+		Clock::time_point start_ = Clock::now();
+
+	public:
+		void restart() { start_ = Clock::now(); }
+		double elapsed_seconds() const
+		{
+			return std::chrono::duration<double>(Clock::now() - start_).count();
+		}
+		uint64_t elapsed_nanoseconds() const
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count());
+		}
+	};
+
+	//xorshift, cheap enough that it doesn't show up in the measurement
+	class FastRandom
+	{
+		uint64_t state_;
+
+	public:
+		explicit FastRandom(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ull + 1) {}
+		uint64_t next()
+		{
+			state_ ^= state_ << 13;
+			state_ ^= state_ >> 7;
+			state_ ^= state_ << 17;
+			return state_;
+		}
+		uint64_t next(uint64_t bound) { return next() % bound; }
+	};
+
+	//keys 0..n-1 where key k is drawn with probability proportional to 1 / (k + 1)^skew
+	class ZipfGenerator
+	{
+		std::vector<double> cumulative_;
+		FastRandom random_;
+
+	public:
+		ZipfGenerator(uint64_t key_count, double skew, uint64_t seed) : cumulative_(key_count), random_(seed)
+		{
+			double total = 0;
+			for (uint64_t key = 0; key < key_count; key++)
+			{
+				total += 1.0 / std::pow(static_cast<double>(key + 1), skew);
+				cumulative_[key] = total;
+			}
+			for (double& value : cumulative_)
+			{
+				value /= total;
+			}
+		}
+
+		uint64_t next()
+		{
+			const double uniform = static_cast<double>(random_.next() >> 11) * (1.0 / 9007199254740992.0);
+			auto got = std::lower_bound(cumulative_.begin(), cumulative_.end(), uniform);
+			if (got == cumulative_.end()) --got;
+			return static_cast<uint64_t>(got - cumulative_.begin());
+		}
+	};
+
+	//1, 2, 4 ... up to and including the number of hardware threads
+	inline std::vector<int> thread_counts()
+	{
+		const int hardware = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		std::vector<int> counts;
+		for (int count = 1; count < hardware; count *= 2)
+		{
+			counts.push_back(count);
+		}
+		counts.push_back(hardware);
+		return counts;
+	}
+
+	//starts thread_count threads running work(thread_index) together and returns the wall time
+	template<typename TWork>
+	double run_threads(int thread_count, TWork work)
+	{
+		std::vector<std::thread> threads;
+		Stopwatch stopwatch;
+		for (int thread_index = 0; thread_index < thread_count; thread_index++)
+		{
+			threads.emplace_back([&work, thread_index] { work(thread_index); });
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		return stopwatch.elapsed_seconds();
+	}
+
+	//percentile in [0, 1], reorders samples
+	inline uint64_t percentile(std::vector<uint64_t>& samples, double fraction)
+	{
+		if (samples.empty()) return 0;
+		const size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())));
+		std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+		return samples[index];
+	}
+
+	inline void print_header(const std::string& title)
+	{
+		std::cout << "\n== " << title << " ==\n";
+	}
+
+	inline void print_row(const std::string& label, double value, const std::string& unit)
+	{
+		std::cout << "  " << std::left << std::setw(40) << label << std::right << std::setw(16) << std::fixed
+			<< std::setprecision(value < 100 ? 2 : 0) << value << " " << unit << "\n";
+	}
+}
@@ -0,0 +1,51 @@
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include "Benchmarks.h"
+
+using namespace benchmarks;
+
+//run with no arguments for every benchmark, or name the ones to run
+int main(int argc, char** argv)
+{
+	const std::map<std::string, std::function<void()>> all_benchmarks =
+	{
+		{ "concurrent_lru_cache", concurrent_lru_cache_benchmark },
+		{ "concurrent_lru_cache_hit_latency", concurrent_lru_cache_hit_latency_benchmark },
+		{ "eviction_policy", eviction_policy_benchmark },
+		{ "batch_lru_cache", batch_lru_cache_benchmark },
+		{ "flat_hash_map", flat_hash_map_benchmark },
+		{ "array_deque", array_deque_benchmark },
+		{ "array_deque_batch", array_deque_batch_benchmark },
+		{ "spsc_ring_buffer", spsc_ring_buffer_benchmark },
+		{ "mpmc_queue", mpmc_queue_benchmark },
+		{ "thread_pool", thread_pool_benchmark },
+		{ "block_deque", block_deque_benchmark },
+	};
+
+	if (argc == 1)
+	{
+		for (auto& [name, benchmark] : all_benchmarks)
+		{
+			benchmark();
+		}
+		return 0;
+	}
+
+	for (int index = 1; index < argc; index++)
+	{
+		auto got = all_benchmarks.find(argv[index]);
+		if (got == all_benchmarks.end())
+		{
+			std::cerr << "unknown benchmark " << argv[index] << ", expected one of:\n";
+			for (auto& [name, _] : all_benchmarks)
+			{
+				std::cerr << "  " << name << "\n";
+			}
+			return 1;
+		}
+		got->second();
+	}
+	return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace benchmarks
+{
+	void concurrent_lru_cache_benchmark();
+	void concurrent_lru_cache_hit_latency_benchmark();
+	void eviction_policy_benchmark();
+	void batch_lru_cache_benchmark();
+	void flat_hash_map_benchmark();
+	void array_deque_benchmark();
+	void array_deque_batch_benchmark();
+	void spsc_ring_buffer_benchmark();
+	void mpmc_queue_benchmark();
+	void thread_pool_benchmark();
+	void block_deque_benchmark();
+}
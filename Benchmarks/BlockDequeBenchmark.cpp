@@ -0,0 +1,86 @@
+#include <vector>
+#include "../Cpp/MyArrayDeque.h"
+#include "../Cpp/MyBlockDeque.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr int FILL_ITEMS = 1 << 22;
+		constexpr int QUEUE_BACKLOG = 1'000'000;
+		constexpr int QUEUE_OPERATIONS = 20'000'000;
+
+		//times every add_last while the deque fills to FILL_ITEMS, the doubling copies only show in the tail
+		template<typename TDeque>
+		void measure_fill(const std::string& label, std::vector<uint64_t>& samples)
+		{
+			samples.clear();
+			TDeque deque;
+			Stopwatch total;
+			for (int item = 0; item < FILL_ITEMS; item++)
+			{
+				Stopwatch stopwatch;
+				deque.add_last(item);
+				samples.push_back(stopwatch.elapsed_nanoseconds());
+			}
+			const double seconds = total.elapsed_seconds();
+			print_row(label + " adds", FILL_ITEMS / seconds, "items/s");
+			print_row(label + " p50", static_cast<double>(percentile(samples, 0.50)), "ns");
+			print_row(label + " p99.9", static_cast<double>(percentile(samples, 0.999)), "ns");
+			print_row(label + " max", static_cast<double>(*std::max_element(samples.begin(), samples.end())), "ns");
+		}
+
+		//a queue holding QUEUE_BACKLOG items, one add_last and one take_first per operation
+		template<typename TDeque>
+		void measure_queue(const std::string& label)
+		{
+			TDeque deque;
+			for (int item = 0; item < QUEUE_BACKLOG; item++)
+			{
+				deque.add_last(item);
+			}
+			int64_t sum = 0;
+			Stopwatch stopwatch;
+			for (int operation = 0; operation < QUEUE_OPERATIONS; operation++)
+			{
+				deque.add_last(operation);
+				sum += deque.take_first();
+			}
+			const double seconds = stopwatch.elapsed_seconds();
+			if (sum == 42) std::cout << "";
+			print_row(label, QUEUE_OPERATIONS / seconds, "ops/s");
+		}
+	}
+
+	void block_deque_benchmark()
+	{
+		std::vector<uint64_t> samples;
+		samples.reserve(FILL_ITEMS);
+		print_header("add_last latency filling to " + std::to_string(FILL_ITEMS) + " ints");
+		measure_fill<MyArrayDeque<int>>("MyArrayDeque", samples);
+		measure_fill<MyBlockDeque<int>>("MyBlockDeque", samples);
+
+		print_header("queue of " + std::to_string(QUEUE_BACKLOG) + " ints, add_last then take_first");
+		measure_queue<MyArrayDeque<int>>("MyArrayDeque");
+		measure_queue<MyBlockDeque<int>>("MyBlockDeque");
+
+		print_header("random reads over " + std::to_string(FILL_ITEMS) + " ints");
+		MyBlockDeque<int> deque;
+		for (int item = 0; item < FILL_ITEMS; item++)
+		{
+			deque.add_last(item);
+		}
+		FastRandom random(7);
+		int64_t sum = 0;
+		Stopwatch stopwatch;
+		for (int read = 0; read < QUEUE_OPERATIONS; read++)
+		{
+			sum += deque[static_cast<int>(random.next(FILL_ITEMS))];
+		}
+		const double seconds = stopwatch.elapsed_seconds();
+		if (sum == 42) std::cout << "";
+		print_row("MyBlockDeque operator[]", QUEUE_OPERATIONS / seconds, "reads/s");
+	}
+}
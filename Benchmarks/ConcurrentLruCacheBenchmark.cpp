@@ -0,0 +1,135 @@
+#include <mutex>
+#include "../Cpp/MyConcurrentLruCache.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr size_t CAPACITY = 1 << 16;
+		constexpr uint64_t KEY_SPACE = CAPACITY * 2;
+		constexpr int OPERATIONS_PER_THREAD = 1'000'000;
+		constexpr int PUT_EVERY = 10; //90% reads
+
+		//what we did before, one lock around one cache
+		class GloballyLockedLruCache
+		{
+			std::mutex mutex_;
+			MyLruCache<uint64_t, uint64_t> cache_;
+
+		public:
+			GloballyLockedLruCache() { cache_.set_capacity(CAPACITY); }
+
+			void put(uint64_t key, uint64_t& value)
+			{
+				std::lock_guard lock(mutex_);
+				cache_.put(key, value);
+			}
+
+			bool try_get(uint64_t key, uint64_t& out_value)
+			{
+				std::lock_guard lock(mutex_);
+				uint64_t* value = cache_.try_get(key);
+				if (value == nullptr) return false;
+				out_value = *value;
+				return true;
+			}
+		};
+
+		template<typename TCache>
+		double measure_ops_per_second(TCache& cache, int thread_count)
+		{
+			const double seconds = run_threads(thread_count, [&cache](int thread_index)
+			{
+				FastRandom random(thread_index + 1);
+				uint64_t sink = 0;
+				for (int operation = 0; operation < OPERATIONS_PER_THREAD; operation++)
+				{
+					uint64_t key = random.next(KEY_SPACE);
+					if (operation % PUT_EVERY == 0)
+					{
+						cache.put(key, key);
+					}
+					else
+					{
+						cache.try_get(key, sink);
+					}
+				}
+			});
+			return static_cast<double>(thread_count) * OPERATIONS_PER_THREAD / seconds;
+		}
+
+		//every get hits, one in SAMPLE_EVERY is timed so the clock reads don't dominate
+		constexpr int SAMPLE_EVERY = 8;
+
+		void measure_hit_latency(MyConcurrentLruCache<uint64_t, uint64_t>& cache, int thread_count, const std::string& label)
+		{
+			std::vector<std::vector<uint64_t>> samples_per_thread(thread_count);
+			run_threads(thread_count, [&cache, &samples_per_thread](int thread_index)
+			{
+				std::vector<uint64_t>& samples = samples_per_thread[thread_index];
+				samples.reserve(OPERATIONS_PER_THREAD / SAMPLE_EVERY + 1);
+				FastRandom random(thread_index + 1);
+				uint64_t sink = 0;
+				for (int operation = 0; operation < OPERATIONS_PER_THREAD; operation++)
+				{
+					const uint64_t key = random.next(CAPACITY);
+					if (operation % SAMPLE_EVERY != 0)
+					{
+						cache.try_get(key, sink);
+						continue;
+					}
+					Stopwatch stopwatch;
+					cache.try_get(key, sink);
+					samples.push_back(stopwatch.elapsed_nanoseconds());
+				}
+			});
+
+			std::vector<uint64_t> samples;
+			for (std::vector<uint64_t>& thread_samples : samples_per_thread)
+			{
+				samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+			}
+			print_row(label + " p50", static_cast<double>(percentile(samples, 0.50)), "ns");
+			print_row(label + " p99", static_cast<double>(percentile(samples, 0.99)), "ns");
+		}
+	}
+
+	void concurrent_lru_cache_benchmark()
+	{
+		print_header("concurrent lru cache, 90% get / 10% put, ops/sec");
+		for (int thread_count : thread_counts())
+		{
+			GloballyLockedLruCache global;
+			MyConcurrentLruCache<uint64_t, uint64_t> sharded;
+			sharded.set_capacity(CAPACITY);
+
+			const std::string threads = std::to_string(thread_count) + " thread(s)";
+			print_row(threads + " global mutex", measure_ops_per_second(global, thread_count), "ops/s");
+			print_row(threads + " sharded", measure_ops_per_second(sharded, thread_count), "ops/s");
+		}
+	}
+
+	void concurrent_lru_cache_hit_latency_benchmark()
+	{
+		print_header("concurrent lru cache hit latency, 100% get");
+		for (int thread_count : thread_counts())
+		{
+			for (size_t drain_threshold : { static_cast<size_t>(0), READ_BUFFER_SIZE / 2 })
+			{
+				MyConcurrentLruCache<uint64_t, uint64_t> cache;
+				cache.set_capacity(CAPACITY);
+				cache.set_drain_threshold(drain_threshold);
+				for (uint64_t key = 0; key < CAPACITY; key++)
+				{
+					cache.put(key, key);
+				}
+				const std::string mode = drain_threshold == 0 ? " locked" : " buffered";
+				measure_hit_latency(cache, thread_count, std::to_string(thread_count) + " thread(s)" + mode);
+			}
+		}
+	}
+}
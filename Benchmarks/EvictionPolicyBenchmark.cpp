@@ -0,0 +1,117 @@
+#include <map>
+#include <unordered_map>
+#include "../Cpp/MyLruCache.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr uint64_t KEY_COUNT = 1'000'000;
+		constexpr size_t CAPACITY = 10'000;
+		constexpr int OPERATIONS = 5'000'000;
+
+		//the original MyLruCache layout, a timestamp per key and a std::map ordered by timestamp,
+		//kept here only as the baseline the intrusive policies are measured against
+		class MapLruCache
+		{
+			uint64_t time_ = 0;
+			std::unordered_map<uint64_t, uint64_t> key_to_last_used_;
+			std::map<uint64_t, uint64_t> last_used_to_key_;
+			std::unordered_map<uint64_t, uint64_t> key_to_value_;
+
+		public:
+			uint64_t* try_get(const uint64_t& key)
+			{
+				auto got = key_to_value_.find(key);
+				if (got == key_to_value_.end()) return nullptr;
+				uint64_t& last_used = key_to_last_used_[key];
+				last_used_to_key_.erase(last_used);
+				last_used = ++time_;
+				last_used_to_key_[last_used] = key;
+				return &got->second;
+			}
+
+			void put(const uint64_t& key, uint64_t& value)
+			{
+				auto got = key_to_last_used_.find(key);
+				if (got != key_to_last_used_.end()) last_used_to_key_.erase(got->second);
+				const uint64_t time = ++time_;
+				key_to_value_[key] = value;
+				key_to_last_used_[key] = time;
+				last_used_to_key_[time] = key;
+				while (key_to_value_.size() > CAPACITY)
+				{
+					auto oldest = last_used_to_key_.begin();
+					key_to_value_.erase(oldest->second);
+					key_to_last_used_.erase(oldest->second);
+					last_used_to_key_.erase(oldest);
+				}
+			}
+		};
+
+		//read through, a miss loads and puts the key
+		template<typename TCache>
+		void measure(TCache& cache, const std::vector<uint64_t>& trace, const std::string& label)
+		{
+			uint64_t hits = 0;
+			Stopwatch stopwatch;
+			for (uint64_t key : trace)
+			{
+				if (cache.try_get(key) != nullptr)
+				{
+					++hits;
+					continue;
+				}
+				uint64_t value = key;
+				cache.put(key, value);
+			}
+			const double seconds = stopwatch.elapsed_seconds();
+			print_row(label + " hit ratio", 100.0 * static_cast<double>(hits) / static_cast<double>(trace.size()), "%");
+			print_row(label + " throughput", static_cast<double>(trace.size()) / seconds, "ops/s");
+		}
+
+		template<template<typename> class TPolicy>
+		void measure_policy(const std::vector<uint64_t>& trace, const std::string& label)
+		{
+			MyLruCache<uint64_t, uint64_t, TPolicy> cache;
+			cache.set_capacity(CAPACITY);
+			measure(cache, trace, label);
+		}
+
+		void measure_all(const std::vector<uint64_t>& trace)
+		{
+			MapLruCache map_lru;
+			measure(map_lru, trace, "std::map lru");
+			measure_policy<LruPolicy>(trace, "intrusive lru");
+			measure_policy<ClockPolicy>(trace, "clock");
+			measure_policy<WTinyLfuPolicy>(trace, "w-tinylfu");
+		}
+	}
+
+	void eviction_policy_benchmark()
+	{
+		std::vector<uint64_t> trace;
+		trace.reserve(OPERATIONS);
+
+		ZipfGenerator zipf(KEY_COUNT, 0.99, 1);
+		for (int operation = 0; operation < OPERATIONS; operation++)
+		{
+			trace.push_back(zipf.next());
+		}
+		print_header("eviction policies, zipf 0.99 over 1M keys, capacity 10k");
+		measure_all(trace);
+
+		//the same zipf traffic with a sequential scan of never repeated keys mixed into every other slot
+		uint64_t scan_key = KEY_COUNT;
+		for (size_t index = 0; index < trace.size(); index += 2)
+		{
+			trace[index] = scan_key++;
+		}
+		print_header("eviction policies, zipf 0.99 interleaved with a scan, capacity 10k");
+		measure_all(trace);
+	}
+}
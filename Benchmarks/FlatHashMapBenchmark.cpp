@@ -0,0 +1,111 @@
+#include <unordered_map>
+#include "../Cpp/MyFlatHashMap.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr uint64_t KEY_COUNTS[] = { 10'000, 1'000'000 };
+		constexpr int LOOKUPS = 5'000'000;
+
+		size_t counted_bytes = 0;
+
+		//std::allocator that adds up what it hands out, so the node map's memory can be measured
+		template<typename T>
+		struct CountingAllocator
+		{
+			using value_type = T;
+
+			CountingAllocator() = default;
+			template<typename TOther>
+			CountingAllocator(const CountingAllocator<TOther>&) {}
+
+			T* allocate(size_t count)
+			{
+				counted_bytes += count * sizeof(T);
+				return std::allocator<T>().allocate(count);
+			}
+			void deallocate(T* pointer, size_t count)
+			{
+				counted_bytes -= count * sizeof(T);
+				std::allocator<T>().deallocate(pointer, count);
+			}
+			template<typename TOther>
+			bool operator==(const CountingAllocator<TOther>&) const { return true; }
+			template<typename TOther>
+			bool operator!=(const CountingAllocator<TOther>&) const { return false; }
+		};
+
+		using NodeMap = std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>, CountingAllocator<std::pair<const uint64_t, uint64_t>>>;
+		using FlatMap = MyFlatHashMap<uint64_t, uint64_t>;
+
+		uint64_t* find(NodeMap& map, uint64_t key)
+		{
+			auto got = map.find(key);
+			return got == map.end() ? nullptr : &got->second;
+		}
+
+		uint64_t* find(FlatMap& map, uint64_t key)
+		{
+			auto* got = map.find(key);
+			return got == nullptr ? nullptr : &got->second;
+		}
+
+		//keys are scattered so neither map gets the sequential layout for free
+		uint64_t key_at(uint64_t index)
+		{
+			return index * 0x9E3779B97F4A7C15ull;
+		}
+
+		template<typename TMap>
+		void measure(TMap& map, uint64_t key_count, const std::string& label, size_t (*bytes)(const TMap&))
+		{
+			Stopwatch stopwatch;
+			for (uint64_t index = 0; index < key_count; index++)
+			{
+				map.insert({ key_at(index), index });
+			}
+			const double insert_seconds = stopwatch.elapsed_seconds();
+			print_row(label + " memory", static_cast<double>(bytes(map)) / static_cast<double>(key_count), "bytes/entry");
+			print_row(label + " insert", insert_seconds * 1e9 / static_cast<double>(key_count), "ns/op");
+
+			FastRandom random(1);
+			uint64_t sink = 0;
+			stopwatch.restart();
+			for (int lookup = 0; lookup < LOOKUPS; lookup++)
+			{
+				sink += *find(map, key_at(random.next(key_count)));
+			}
+			print_row(label + " hit", stopwatch.elapsed_seconds() * 1e9 / LOOKUPS, "ns/op");
+
+			stopwatch.restart();
+			for (int lookup = 0; lookup < LOOKUPS; lookup++)
+			{
+				sink += find(map, key_at(key_count + random.next(key_count))) == nullptr ? 1 : 0;
+			}
+			print_row(label + " miss", stopwatch.elapsed_seconds() * 1e9 / LOOKUPS, "ns/op");
+			if (sink == 42) std::cout << "";
+		}
+	}
+
+	void flat_hash_map_benchmark()
+	{
+		for (uint64_t key_count : KEY_COUNTS)
+		{
+			print_header("unordered_map vs MyFlatHashMap, " + std::to_string(key_count) + " uint64_t keys");
+			{
+				counted_bytes = 0;
+				NodeMap map;
+				measure<NodeMap>(map, key_count, "unordered_map", [](const NodeMap&) { return counted_bytes; });
+			}
+			{
+				FlatMap map;
+				measure<FlatMap>(map, key_count, "flat", [](const FlatMap& flat) { return flat.allocated_bytes(); });
+			}
+		}
+	}
+}
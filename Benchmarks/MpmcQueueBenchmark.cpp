@@ -0,0 +1,115 @@
+#include <mutex>
+#include "../Cpp/MyArrayDeque.h"
+#include "../Cpp/MyMpmcQueue.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr size_t CAPACITY = 1 << 10;
+		constexpr int TOTAL_ITEMS = 2'000'000;
+		constexpr int THREAD_COUNTS[] = { 1, 2, 4, 8, 16, 32 };
+
+		//what the stages did before, one lock around a MyArrayDeque kept to the same bound as the queue
+		class LockedDeque
+		{
+			std::mutex mutex_;
+			MyArrayDeque<int> deque_;
+
+		public:
+			bool try_offer(int item)
+			{
+				std::lock_guard lock(mutex_);
+				if (deque_.get_count() == static_cast<int>(CAPACITY)) return false;
+				deque_.add_last(item);
+				return true;
+			}
+
+			bool try_poll(int& out_item)
+			{
+				std::lock_guard lock(mutex_);
+				if (deque_.get_count() == 0) return false;
+				out_item = deque_.take_first();
+				return true;
+			}
+		};
+
+		//spins on the non blocking calls, yielding between tries
+		template<typename TQueue>
+		struct Spinning
+		{
+			TQueue& queue;
+
+			void offer(int item)
+			{
+				while (!queue.try_offer(item)) std::this_thread::yield();
+			}
+			int take()
+			{
+				int item = 0;
+				while (!queue.try_poll(item)) std::this_thread::yield();
+				return item;
+			}
+		};
+
+		//half the threads offer and half take, TOTAL_ITEMS between them, a single thread offers then takes
+		//returns items through per second
+		template<typename TQueue>
+		double measure(TQueue queue, int thread_count)
+		{
+			if (thread_count == 1)
+			{
+				Stopwatch stopwatch;
+				int64_t sum = 0;
+				for (int item = 0; item < TOTAL_ITEMS; item++)
+				{
+					queue.offer(item);
+					sum += queue.take();
+				}
+				if (sum == 42) std::cout << "";
+				return TOTAL_ITEMS / stopwatch.elapsed_seconds();
+			}
+
+			const int pairs = thread_count / 2;
+			const int items_each = TOTAL_ITEMS / pairs;
+			std::atomic<int64_t> sum = 0;
+			const double seconds = run_threads(pairs * 2, [&](int thread_index)
+			{
+				if (thread_index < pairs)
+				{
+					for (int item = 0; item < items_each; item++) queue.offer(item);
+					return;
+				}
+				int64_t local_sum = 0;
+				for (int item = 0; item < items_each; item++) local_sum += queue.take();
+				sum += local_sum;
+			});
+			if (sum.load() != static_cast<int64_t>(pairs) * items_each * (items_each - 1) / 2) std::cout << "  lost items\n";
+			return static_cast<double>(items_each) * pairs / seconds;
+		}
+	}
+
+	void mpmc_queue_benchmark()
+	{
+		for (int thread_count : THREAD_COUNTS)
+		{
+			print_header(std::to_string(thread_count) + (thread_count == 1 ? " thread" : " threads, half offering and half taking"));
+			{
+				LockedDeque deque;
+				print_row("mutex + MyArrayDeque", measure(Spinning<LockedDeque>{ deque }, thread_count), "items/s");
+			}
+			{
+				MyMpmcQueue<int> queue(CAPACITY);
+				print_row("MyMpmcQueue", measure(Spinning<MyMpmcQueue<int>>{ queue }, thread_count), "items/s");
+			}
+			{
+				MyBlockingMpmcQueue<int> queue(CAPACITY);
+				print_row("MyBlockingMpmcQueue", measure<MyBlockingMpmcQueue<int>&>(queue, thread_count), "items/s");
+			}
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#include <mutex>
+#include "../Cpp/MyArrayDeque.h"
+#include "../Cpp/MySpscRingBuffer.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr size_t CAPACITY = 1 << 12;
+		constexpr uint64_t ITEMS = 50'000'000;
+		constexpr size_t BATCH = 32;
+
+		//what the pipeline did before, one lock around a MyArrayDeque kept to the same bound as the ring
+		class LockedDeque
+		{
+			std::mutex mutex_;
+			MyArrayDeque<uint64_t> deque_;
+
+		public:
+			bool try_push(uint64_t item)
+			{
+				std::lock_guard lock(mutex_);
+				if (deque_.get_count() == static_cast<int>(CAPACITY)) return false;
+				deque_.add_last(item);
+				return true;
+			}
+
+			bool try_pop(uint64_t& out_item)
+			{
+				std::lock_guard lock(mutex_);
+				if (deque_.get_count() == 0) return false;
+				out_item = deque_.take_first();
+				return true;
+			}
+		};
+
+		//thread 0 produces ITEMS values and thread 1 consumes them, a side that can't make progress yields
+		//so the benchmark still finishes when both threads share a core
+		template<typename TPush, typename TPop>
+		void measure(const std::string& label, TPush push, TPop pop)
+		{
+			uint64_t sum = 0;
+			const double seconds = run_threads(2, [&](int thread_index)
+			{
+				if (thread_index == 0)
+				{
+					for (uint64_t next = 0; next < ITEMS; )
+					{
+						const uint64_t pushed = push(next);
+						if (pushed == 0) std::this_thread::yield();
+						next += pushed;
+					}
+					return;
+				}
+				for (uint64_t received = 0; received < ITEMS; )
+				{
+					const uint64_t popped = pop(sum);
+					if (popped == 0) std::this_thread::yield();
+					received += popped;
+				}
+			});
+			if (sum != ITEMS * (ITEMS - 1) / 2) std::cout << "  " << label << " lost items\n";
+			print_row(label, static_cast<double>(ITEMS) / seconds, "items/s");
+		}
+	}
+
+	void spsc_ring_buffer_benchmark()
+	{
+		print_header("one producer, one consumer, " + std::to_string(CAPACITY) + " items in flight at most");
+		{
+			LockedDeque deque;
+			measure("mutex + MyArrayDeque",
+				[&](uint64_t next) { return deque.try_push(next) ? 1ull : 0ull; },
+				[&](uint64_t& sum)
+				{
+					uint64_t item = 0;
+					if (!deque.try_pop(item)) return 0ull;
+					sum += item;
+					return 1ull;
+				});
+		}
+		{
+			MySpscRingBuffer<uint64_t> ring(CAPACITY);
+			measure("spsc one at a time",
+				[&](uint64_t next) { return ring.try_push(next) ? 1ull : 0ull; },
+				[&](uint64_t& sum)
+				{
+					uint64_t item = 0;
+					if (!ring.try_pop(item)) return 0ull;
+					sum += item;
+					return 1ull;
+				});
+		}
+		{
+			MySpscRingBuffer<uint64_t> ring(CAPACITY);
+			measure("spsc batches of " + std::to_string(BATCH),
+				[&](uint64_t next)
+				{
+					uint64_t batch[BATCH];
+					const size_t count = static_cast<size_t>(std::min<uint64_t>(BATCH, ITEMS - next));
+					for (size_t index = 0; index < count; index++) batch[index] = next + index;
+					return static_cast<uint64_t>(ring.try_push_n(batch, count));
+				},
+				[&](uint64_t& sum)
+				{
+					uint64_t batch[BATCH];
+					const size_t popped = ring.try_pop_n(batch, BATCH);
+					for (size_t index = 0; index < popped; index++) sum += batch[index];
+					return static_cast<uint64_t>(popped);
+				});
+		}
+	}
+}
@@ -0,0 +1,172 @@
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include "../Cpp/MyArrayDeque.h"
+#include "../Cpp/MyThreadPool.h"
+#include "BenchmarkHelpers.h"
+#include "Benchmarks.h"
+
+using namespace ds;
+
+namespace benchmarks
+{
+	namespace
+	{
+		constexpr int64_t FLAT_INDICES = 1 << 22;
+		constexpr int64_t FLAT_GRAIN = 64;
+		constexpr int TREE_DEPTH = 16;
+		constexpr int TREE_REPEATS = 4;
+		constexpr int LEAF_WORK = 64;
+
+		//the usual pool, every thread takes from and gives to one MyArrayDeque behind one lock
+		//parallel_for splits and helps like MyThreadPool's so only the queueing differs, a waiting thread helps with
+		//the newest task as a work stealing owner would, helping with the oldest nests whole other subtrees on its
+		//stack and overflows it on the tree
+		class LockedQueuePool
+		{
+			std::mutex mutex_;
+			std::condition_variable wake_;
+			MyArrayDeque<std::function<void()>> tasks_;
+			bool stopping_ = false;
+			std::vector<std::thread> threads_;
+
+			void enqueue(std::function<void()> task)
+			{
+				{
+					std::lock_guard lock(mutex_);
+					tasks_.add_last(std::move(task));
+				}
+				wake_.notify_one();
+			}
+
+			bool run_newest()
+			{
+				std::function<void()> task;
+				{
+					std::lock_guard lock(mutex_);
+					if (tasks_.get_count() == 0) return false;
+					task = tasks_.take_last();
+				}
+				task();
+				return true;
+			}
+
+		public:
+			explicit LockedQueuePool(int thread_count)
+			{
+				for (int index = 0; index < thread_count; index++)
+				{
+					threads_.emplace_back([this]
+					{
+						while (true)
+						{
+							std::unique_lock lock(mutex_);
+							wake_.wait(lock, [this] { return stopping_ || tasks_.get_count() > 0; });
+							if (tasks_.get_count() == 0) return;
+							std::function<void()> task = tasks_.take_first();
+							lock.unlock();
+							task();
+						}
+					});
+				}
+			}
+
+			~LockedQueuePool()
+			{
+				{
+					std::lock_guard lock(mutex_);
+					stopping_ = true;
+				}
+				wake_.notify_all();
+				for (std::thread& thread : threads_) thread.join();
+			}
+
+			template<typename TBody>
+			void parallel_for(int64_t begin, int64_t end, TBody body, int64_t grain = 1)
+			{
+				std::atomic<int64_t> remaining = end - begin;
+				std::function<void(int64_t, int64_t)> split = [&](int64_t from, int64_t to)
+				{
+					while (to - from > grain)
+					{
+						const int64_t middle = from + (to - from) / 2;
+						enqueue([&split, middle, to] { split(middle, to); });
+						to = middle;
+					}
+					for (int64_t index = from; index < to; index++) body(index);
+					remaining.fetch_sub(to - from, std::memory_order_acq_rel);
+				};
+				split(begin, end);
+				while (remaining.load(std::memory_order_acquire) != 0)
+				{
+					if (!run_newest()) std::this_thread::yield();
+				}
+			}
+		};
+
+		uint32_t mix(uint64_t value)
+		{
+			value ^= value >> 33;
+			value *= 0xFF51AFD7ED558CCDull;
+			value ^= value >> 33;
+			return static_cast<uint32_t>(value);
+		}
+
+		//one parallel_for over FLAT_INDICES cheap bodies in FLAT_GRAIN pieces, returns indices per second
+		template<typename TPool>
+		double measure_flat(TPool& pool)
+		{
+			std::vector<uint32_t> out(FLAT_INDICES);
+			Stopwatch stopwatch;
+			pool.parallel_for(0, FLAT_INDICES, [&](int64_t index) { out[index] = mix(index); }, FLAT_GRAIN);
+			const double seconds = stopwatch.elapsed_seconds();
+			if (out[FLAT_INDICES - 1] != mix(FLAT_INDICES - 1)) std::cout << "  missed indices\n";
+			return FLAT_INDICES / seconds;
+		}
+
+		template<typename TPool>
+		uint64_t tree(TPool& pool, int depth, uint64_t seed)
+		{
+			if (depth == 0)
+			{
+				uint64_t value = seed;
+				for (int round = 0; round < LEAF_WORK; round++) value = mix(value + round);
+				return value;
+			}
+			std::atomic<uint64_t> sum = 0;
+			pool.parallel_for(0, 2, [&](int64_t side) { sum.fetch_add(tree(pool, depth - 1, seed * 2 + side)); });
+			return sum.load();
+		}
+
+		//a binary fork join tree TREE_DEPTH deep where every node is a task and every leaf a little hashing,
+		//returns tasks per second
+		template<typename TPool>
+		double measure_tree(TPool& pool)
+		{
+			Stopwatch stopwatch;
+			uint64_t sum = 0;
+			for (int repeat = 0; repeat < TREE_REPEATS; repeat++) sum += tree(pool, TREE_DEPTH, repeat);
+			const double seconds = stopwatch.elapsed_seconds();
+			if (sum == 42) std::cout << "";
+			return static_cast<double>((int64_t{ 2 } << TREE_DEPTH) - 1) * TREE_REPEATS / seconds;
+		}
+	}
+
+	void thread_pool_benchmark()
+	{
+		for (int thread_count : thread_counts())
+		{
+			print_header(std::to_string(thread_count) + (thread_count == 1 ? " worker" : " workers"));
+			{
+				LockedQueuePool pool(thread_count);
+				print_row("locked queue, flat parallel_for", measure_flat(pool), "indices/s");
+				print_row("locked queue, fork join tree", measure_tree(pool), "tasks/s");
+			}
+			{
+				MyThreadPool pool(thread_count);
+				print_row("work stealing, flat parallel_for", measure_flat(pool), "indices/s");
+				print_row("work stealing, fork join tree", measure_tree(pool), "tasks/s");
+			}
+		}
+	}
+}
@@ -0,0 +1,132 @@
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Simulator.h"
+#include "TraceSources.h"
+
+using namespace simulator;
+
+namespace
+{
+	void print_usage()
+	{
+		std::cerr <<
+			"usage: CacheSimulator <source> [options]\n"
+			"sources:\n"
+			"  --text <path>              one key per line, numbers are used as they are and anything else is hashed\n"
+			"  --binary <path>            little endian uint64 keys back to back\n"
+			"  --zipf <keys>              zipf over keys 0..keys-1\n"
+			"  --scan <keys>              the zipf traffic with every other access a key that is never seen again\n"
+			"  --loop <keys>              keys 0..keys-1 over and over\n"
+			"options:\n"
+			"  --length <n>               accesses a synthetic source makes, default 10000000\n"
+			"  --skew <s>                 zipf skew, default 0.99\n"
+			"  --seed <n>                 default 1\n"
+			"  --capacities <a,b,...>     default 1000,10000,100000\n"
+			"  --policies <a,b,...>       any of lru,clock,tinylfu, default all of them\n"
+			"  --write-binary <path>      write the source out as a binary trace instead of simulating\n";
+	}
+
+	std::vector<std::string> split(const std::string& list)
+	{
+		std::vector<std::string> parts;
+		std::stringstream stream(list);
+		std::string part;
+		while (std::getline(stream, part, ','))
+		{
+			if (!part.empty())
+			{
+				parts.push_back(part);
+			}
+		}
+		return parts;
+	}
+}
+
+//replays a trace against MyLruCache for every policy and capacity asked for
+int main(int argc, char** argv)
+{
+	std::string source_kind;
+	std::string source_argument;
+	uint64_t length = 10'000'000;
+	double skew = 0.99;
+	uint64_t seed = 1;
+	std::vector<size_t> capacities = { 1'000, 10'000, 100'000 };
+	std::vector<std::string> policies = policy_names();
+	std::string write_binary_path;
+
+	try
+	{
+		for (int index = 1; index < argc; index++)
+		{
+			const std::string option = argv[index];
+			if (index + 1 == argc)
+			{
+				print_usage();
+				return 1;
+			}
+			const std::string value = argv[++index];
+
+			if (option == "--text" || option == "--binary" || option == "--zipf" || option == "--scan" || option == "--loop")
+			{
+				source_kind = option;
+				source_argument = value;
+			}
+			else if (option == "--length") length = std::stoull(value);
+			else if (option == "--skew") skew = std::stod(value);
+			else if (option == "--seed") seed = std::stoull(value);
+			else if (option == "--policies") policies = split(value);
+			else if (option == "--write-binary") write_binary_path = value;
+			else if (option == "--capacities")
+			{
+				capacities.clear();
+				for (const std::string& capacity : split(value))
+				{
+					capacities.push_back(static_cast<size_t>(std::stoull(capacity)));
+				}
+			}
+			else
+			{
+				print_usage();
+				return 1;
+			}
+		}
+		if (source_kind.empty())
+		{
+			print_usage();
+			return 1;
+		}
+
+		std::unique_ptr<ITraceSource> source;
+		if (source_kind == "--text") source = std::make_unique<TextTraceSource>(source_argument);
+		else if (source_kind == "--binary") source = std::make_unique<BinaryTraceSource>(source_argument);
+		else if (source_kind == "--zipf") source = std::make_unique<ZipfTraceSource>(std::stoull(source_argument), skew, length, seed);
+		else if (source_kind == "--scan") source = std::make_unique<ScanTraceSource>(std::stoull(source_argument), skew, length, seed);
+		else source = std::make_unique<LoopTraceSource>(std::stoull(source_argument), length);
+
+		if (!write_binary_path.empty())
+		{
+			const uint64_t written = write_binary_trace(*source, write_binary_path);
+			std::cout << "wrote " << written << " keys to " << write_binary_path << "\n";
+			return 0;
+		}
+
+		print_result_header(source->describe());
+		for (size_t capacity : capacities)
+		{
+			for (const std::string& policy : policies)
+			{
+				print_result(simulate(*source, policy, capacity));
+			}
+		}
+	}
+	catch (const std::exception& error)
+	{
+		std::cerr << error.what() << "\n";
+		return 1;
+	}
+	return 0;
+}
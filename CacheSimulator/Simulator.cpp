@@ -0,0 +1,166 @@
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include "../Cpp/MyLruCache.h"
+#include "Simulator.h"
+
+using namespace ds;
+
+namespace
+{
+	//every heap block carries its size in front of it so the simulator can tell how much the cache holds,
+	//the simulator is single threaded so a plain counter will do
+	constexpr size_t BLOCK_HEADER = alignof(std::max_align_t);
+	size_t live_heap_bytes = 0;
+}
+
+void* operator new(size_t size)
+{
+	void* block = std::malloc(size + BLOCK_HEADER);
+	if (block == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	*static_cast<size_t*>(block) = size;
+	live_heap_bytes += size;
+	return static_cast<char*>(block) + BLOCK_HEADER;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory == nullptr)
+	{
+		return;
+	}
+	void* block = static_cast<char*>(memory) - BLOCK_HEADER;
+	live_heap_bytes -= *static_cast<size_t*>(block);
+	std::free(block);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+namespace simulator
+{
+	namespace
+	{
+		constexpr size_t BATCH_KEYS = 4096;
+
+		template<template<typename> class TPolicy>
+		SimulationResult replay(ITraceSource& source, size_t capacity)
+		{
+			SimulationResult result;
+			result.capacity = capacity;
+			std::vector<uint64_t> keys(BATCH_KEYS);
+			source.reset();
+
+			//anything the source allocates while the cache is alive is taken back out of the count
+			size_t source_bytes = 0;
+			const size_t baseline_bytes = live_heap_bytes;
+			{
+				MyLruCache<uint64_t, uint64_t, TPolicy> cache;
+				cache.set_capacity(capacity);
+
+				benchmarks::Stopwatch stopwatch;
+				while (true)
+				{
+					const size_t before_read = live_heap_bytes;
+					const size_t count = source.next_batch(keys.data(), keys.size());
+					source_bytes += live_heap_bytes - before_read;
+					if (count == 0)
+					{
+						break;
+					}
+
+					stopwatch.restart();
+					for (size_t index = 0; index < count; index++)
+					{
+						const uint64_t key = keys[index];
+						if (cache.try_get(key) != nullptr)
+						{
+							++result.hits;
+							continue;
+						}
+						uint64_t value = key;
+						cache.put(key, value);
+					}
+					result.seconds += stopwatch.elapsed_seconds();
+					result.accesses += count;
+				}
+
+				result.entries = cache.size();
+				result.heap_bytes = live_heap_bytes - baseline_bytes - source_bytes;
+			}
+			return result;
+		}
+	}
+
+	//O(1)
+	double SimulationResult::hit_ratio() const
+	{
+		return accesses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(accesses);
+	}
+
+	//O(1)
+	double SimulationResult::operations_per_second() const
+	{
+		return seconds == 0 ? 0.0 : static_cast<double>(accesses) / seconds;
+	}
+
+	//O(1)
+	double SimulationResult::bytes_per_entry() const
+	{
+		return entries == 0 ? 0.0 : static_cast<double>(heap_bytes) / static_cast<double>(entries);
+	}
+
+	const std::vector<std::string>& policy_names()
+	{
+		static const std::vector<std::string> names = { "lru", "clock", "tinylfu" };
+		return names;
+	}
+
+	//O(trace length)
+	SimulationResult simulate(ITraceSource& source, const std::string& policy, size_t capacity)
+	{
+		SimulationResult result;
+		if (policy == "lru")
+		{
+			result = replay<LruPolicy>(source, capacity);
+		}
+		else if (policy == "clock")
+		{
+			result = replay<ClockPolicy>(source, capacity);
+		}
+		else if (policy == "tinylfu")
+		{
+			result = replay<WTinyLfuPolicy>(source, capacity);
+		}
+		else
+		{
+			throw std::exception("unknown policy");
+		}
+		result.policy = policy;
+		return result;
+	}
+
+	void print_result_header(const std::string& title)
+	{
+		std::cout << "\n== " << title << " ==\n";
+		std::cout << "  " << std::left << std::setw(10) << "policy" << std::right << std::setw(12) << "capacity"
+			<< std::setw(14) << "accesses" << std::setw(12) << "hit ratio" << std::setw(16) << "ops/s"
+			<< std::setw(16) << "bytes/entry" << "\n";
+	}
+
+	void print_result(const SimulationResult& result)
+	{
+		std::cout << "  " << std::left << std::setw(10) << result.policy << std::right << std::setw(12) << result.capacity
+			<< std::setw(14) << result.accesses << std::fixed << std::setprecision(2) << std::setw(11) << 100.0 * result.hit_ratio() << "%"
+			<< std::setprecision(0) << std::setw(16) << result.operations_per_second()
+			<< std::setprecision(1) << std::setw(16) << result.bytes_per_entry() << "\n";
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TraceSources.h"
+
+namespace simulator
+{
+	struct SimulationResult
+	{
+		std::string policy;
+		size_t capacity = 0;
+		uint64_t accesses = 0;
+		uint64_t hits = 0;
+		double seconds = 0; //time spent in the cache, reading the trace isn't counted
+		size_t entries = 0; //held at the end of the run
+		size_t heap_bytes = 0; //heap held by the cache at the end of the run
+
+		double hit_ratio() const;
+		double operations_per_second() const;
+		double bytes_per_entry() const;
+	};
+
+	//lru, clock and tinylfu
+	const std::vector<std::string>& policy_names();
+
+	//replays the source from the start against a fresh MyLruCache<uint64_t, uint64_t> of the named policy,
+	//every access is a lookup and a miss puts the key, like a read through cache in front of a store
+	SimulationResult simulate(ITraceSource& source, const std::string& policy, size_t capacity);
+
+	void print_result_header(const std::string& title);
+	void print_result(const SimulationResult& result);
+}
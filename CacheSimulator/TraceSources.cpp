@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include "TraceSources.h"
+
+namespace simulator
+{
+	namespace
+	{
+		constexpr size_t BINARY_BLOCK_KEYS = 64 * 1024;
+
+		std::ifstream open_trace(const std::string& path, std::ios::openmode mode)
+		{
+			std::ifstream file(path, mode);
+			if (!file)
+			{
+				throw std::exception("could not open trace file");
+			}
+			return file;
+		}
+
+		//the first word of the line, a number if the whole word parses as one and a hash otherwise
+		bool parse_key(const std::string& line, uint64_t& out_key)
+		{
+			const char* begin = line.data();
+			const char* end = line.data() + line.size();
+			while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) ++begin;
+			const char* word_end = begin;
+			while (word_end != end && *word_end != ' ' && *word_end != '\t' && *word_end != '\r' && *word_end != ',') ++word_end;
+			if (begin == word_end)
+			{
+				return false;
+			}
+
+			auto [parsed_end, error] = std::from_chars(begin, word_end, out_key);
+			if (error != std::errc() || parsed_end != word_end)
+			{
+				out_key = std::hash<std::string_view>()(std::string_view(begin, static_cast<size_t>(word_end - begin)));
+			}
+			return true;
+		}
+
+		std::string describe_zipf(uint64_t key_count, double skew)
+		{
+			std::ostringstream description;
+			description << "zipf " << skew << " over " << key_count << " keys";
+			return description.str();
+		}
+	}
+
+	/*** TextTraceSource ***/
+
+	TextTraceSource::TextTraceSource(const std::string& path) : path_(path), file_(open_trace(path, std::ios::in))
+	{
+	}
+
+	//O(max_keys)
+	size_t TextTraceSource::next_batch(uint64_t* out_keys, size_t max_keys)
+	{
+		size_t count = 0;
+		while (count < max_keys && std::getline(file_, line_))
+		{
+			if (parse_key(line_, out_keys[count]))
+			{
+				++count;
+			}
+		}
+		return count;
+	}
+
+	//O(1)
+	void TextTraceSource::reset()
+	{
+		file_.clear();
+		file_.seekg(0);
+	}
+
+	std::string TextTraceSource::describe() const
+	{
+		return "text trace " + path_;
+	}
+
+	/*** BinaryTraceSource ***/
+
+	BinaryTraceSource::BinaryTraceSource(const std::string& path)
+		: path_(path), file_(open_trace(path, std::ios::in | std::ios::binary)), block_(BINARY_BLOCK_KEYS * sizeof(uint64_t))
+	{
+	}
+
+	//O(max_keys)
+	//decoded byte by byte so the trace reads the same on any endianness, a trailing partial key is ignored
+	size_t BinaryTraceSource::next_batch(uint64_t* out_keys, size_t max_keys)
+	{
+		const size_t want = std::min(max_keys, BINARY_BLOCK_KEYS);
+		file_.read(reinterpret_cast<char*>(block_.data()), static_cast<std::streamsize>(want * sizeof(uint64_t)));
+		const size_t count = static_cast<size_t>(file_.gcount()) / sizeof(uint64_t);
+		for (size_t index = 0; index < count; index++)
+		{
+			const unsigned char* bytes = &block_[index * sizeof(uint64_t)];
+			uint64_t key = 0;
+			for (int byte = 7; byte >= 0; byte--)
+			{
+				key = (key << 8) | bytes[byte];
+			}
+			out_keys[index] = key;
+		}
+		return count;
+	}
+
+	//O(1)
+	void BinaryTraceSource::reset()
+	{
+		file_.clear();
+		file_.seekg(0);
+	}
+
+	std::string BinaryTraceSource::describe() const
+	{
+		return "binary trace " + path_;
+	}
+
+	/*** ZipfTraceSource ***/
+
+	ZipfTraceSource::ZipfTraceSource(uint64_t key_count, double skew, uint64_t length, uint64_t seed)
+		: key_count_(key_count), skew_(skew), length_(length), seed_(seed), zipf_(key_count, skew, seed)
+	{
+	}
+
+	//O(max_keys log key_count)
+	size_t ZipfTraceSource::next_batch(uint64_t* out_keys, size_t max_keys)
+	{
+		const size_t count = static_cast<size_t>(std::min<uint64_t>(max_keys, length_ - emitted_));
+		for (size_t index = 0; index < count; index++)
+		{
+			out_keys[index] = zipf_.next();
+		}
+		emitted_ += count;
+		return count;
+	}
+
+	//O(key_count)
+	//reseeding rebuilds the distribution, which keeps every run on exactly the same keys
+	void ZipfTraceSource::reset()
+	{
+		zipf_ = benchmarks::ZipfGenerator(key_count_, skew_, seed_);
+		emitted_ = 0;
+	}
+
+	std::string ZipfTraceSource::describe() const
+	{
+		return describe_zipf(key_count_, skew_);
+	}
+
+	/*** ScanTraceSource ***/
+
+	ScanTraceSource::ScanTraceSource(uint64_t key_count, double skew, uint64_t length, uint64_t seed)
+		: key_count_(key_count), skew_(skew), length_(length), seed_(seed), zipf_(key_count, skew, seed)
+	{
+	}
+
+	//O(max_keys log key_count)
+	//scan keys start past the zipf keys so the two never collide
+	size_t ScanTraceSource::next_batch(uint64_t* out_keys, size_t max_keys)
+	{
+		const size_t count = static_cast<size_t>(std::min<uint64_t>(max_keys, length_ - emitted_));
+		for (size_t index = 0; index < count; index++)
+		{
+			const uint64_t position = emitted_ + index;
+			out_keys[index] = position % 2 == 0 ? key_count_ + position / 2 : zipf_.next();
+		}
+		emitted_ += count;
+		return count;
+	}
+
+	//O(key_count)
+	void ScanTraceSource::reset()
+	{
+		zipf_ = benchmarks::ZipfGenerator(key_count_, skew_, seed_);
+		emitted_ = 0;
+	}
+
+	std::string ScanTraceSource::describe() const
+	{
+		return describe_zipf(key_count_, skew_) + " interleaved with a scan";
+	}
+
+	/*** LoopTraceSource ***/
+
+	LoopTraceSource::LoopTraceSource(uint64_t key_count, uint64_t length) : key_count_(key_count), length_(length)
+	{
+	}
+
+	//O(max_keys)
+	size_t LoopTraceSource::next_batch(uint64_t* out_keys, size_t max_keys)
+	{
+		const size_t count = static_cast<size_t>(std::min<uint64_t>(max_keys, length_ - emitted_));
+		for (size_t index = 0; index < count; index++)
+		{
+			out_keys[index] = (emitted_ + index) % key_count_;
+		}
+		emitted_ += count;
+		return count;
+	}
+
+	//O(1)
+	void LoopTraceSource::reset()
+	{
+		emitted_ = 0;
+	}
+
+	std::string LoopTraceSource::describe() const
+	{
+		return "loop over " + std::to_string(key_count_) + " keys";
+	}
+
+	//O(keys)
+	uint64_t write_binary_trace(ITraceSource& source, const std::string& path)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			throw std::exception("could not create trace file");
+		}
+
+		std::vector<uint64_t> keys(BINARY_BLOCK_KEYS);
+		std::vector<unsigned char> bytes(BINARY_BLOCK_KEYS * sizeof(uint64_t));
+		uint64_t written = 0;
+		source.reset();
+		while (size_t count = source.next_batch(keys.data(), keys.size()))
+		{
+			for (size_t index = 0; index < count; index++)
+			{
+				for (size_t byte = 0; byte < sizeof(uint64_t); byte++)
+				{
+					bytes[index * sizeof(uint64_t) + byte] = static_cast<unsigned char>(keys[index] >> (8 * byte));
+				}
+			}
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(count * sizeof(uint64_t)));
+			written += count;
+		}
+		if (!file)
+		{
+			throw std::exception("could not write trace file");
+		}
+		return written;
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../Benchmarks/BenchmarkHelpers.h"
+
+namespace simulator
+{
+	//a stream of keys that can be replayed from the start, one run per capacity and policy
+	//sources hand keys out in batches so a trace never has to be held in memory
+	class ITraceSource
+	{
+	public:
+		virtual ~ITraceSource() = default;
+		//fills up to max_keys keys, returns how many were written, 0 once the trace is over
+		virtual size_t next_batch(uint64_t* out_keys, size_t max_keys) = 0;
+		virtual void reset() = 0;
+		virtual std::string describe() const = 0;
+	};
+
+	//one key per line, the first word of a line is the key
+	//numeric keys are used as they are and anything else is hashed, blank lines are skipped
+	class TextTraceSource : public ITraceSource
+	{
+		std::string path_;
+		std::ifstream file_;
+		std::string line_;
+
+	public:
+		explicit TextTraceSource(const std::string& path);
+		size_t next_batch(uint64_t* out_keys, size_t max_keys) override;
+		void reset() override;
+		std::string describe() const override;
+	};
+
+	//little endian uint64 keys back to back, read a block at a time
+	class BinaryTraceSource : public ITraceSource
+	{
+		std::string path_;
+		std::ifstream file_;
+		std::vector<unsigned char> block_;
+
+	public:
+		explicit BinaryTraceSource(const std::string& path);
+		size_t next_batch(uint64_t* out_keys, size_t max_keys) override;
+		void reset() override;
+		std::string describe() const override;
+	};
+
+	//zipf over keys 0..key_count-1, a few hot keys and a long tail
+	class ZipfTraceSource : public ITraceSource
+	{
+		uint64_t key_count_;
+		double skew_;
+		uint64_t length_;
+		uint64_t seed_;
+		uint64_t emitted_ = 0;
+		benchmarks::ZipfGenerator zipf_;
+
+	public:
+		ZipfTraceSource(uint64_t key_count, double skew, uint64_t length, uint64_t seed);
+		size_t next_batch(uint64_t* out_keys, size_t max_keys) override;
+		void reset() override;
+		std::string describe() const override;
+	};
+
+	//the zipf traffic with every other access taken by a sequential scan of keys that never repeat,
+	//the scan only pollutes the cache so this shows how well a policy keeps the hot keys
+	class ScanTraceSource : public ITraceSource
+	{
+		uint64_t key_count_;
+		double skew_;
+		uint64_t length_;
+		uint64_t seed_;
+		uint64_t emitted_ = 0;
+		benchmarks::ZipfGenerator zipf_;
+
+	public:
+		ScanTraceSource(uint64_t key_count, double skew, uint64_t length, uint64_t seed);
+		size_t next_batch(uint64_t* out_keys, size_t max_keys) override;
+		void reset() override;
+		std::string describe() const override;
+	};
+
+	//0..key_count-1 over and over, lru misses on every access once the loop is larger than the cache
+	class LoopTraceSource : public ITraceSource
+	{
+		uint64_t key_count_;
+		uint64_t length_;
+		uint64_t emitted_ = 0;
+
+	public:
+		LoopTraceSource(uint64_t key_count, uint64_t length);
+		size_t next_batch(uint64_t* out_keys, size_t max_keys) override;
+		void reset() override;
+		std::string describe() const override;
+	};
+
+	//writes the whole source out in the binary trace format, returns the number of keys written
+	uint64_t write_binary_trace(ITraceSource& source, const std::string& path);
+}
@@ -33,6 +33,101 @@ protected:
 	}
 };
 
+//a string that counts how often it gets copied and how many are alive
+struct CountedText
+{
+	static int copies;
+	static int alive;
+	string text;
+
+	CountedText() { ++alive; }
+	CountedText(const char* chars) : text(chars) { ++alive; }
+	CountedText(size_t count, char fill) : text(count, fill) { ++alive; }
+	CountedText(const CountedText& other) : text(other.text) { ++copies; ++alive; }
+	CountedText(CountedText&& other) noexcept : text(std::move(other.text)) { ++alive; }
+	CountedText& operator=(const CountedText& other) { text = other.text; ++copies; return *this; }
+	CountedText& operator=(CountedText&&) noexcept = default;
+	~CountedText() { --alive; }
+};
+
+int CountedText::copies = 0;
+int CountedText::alive = 0;
+
+//trivially copyable but with no default constructor
+struct Point
+{
+	int x;
+	int y;
+	Point(int x_value, int y_value) : x(x_value), y(y_value) {}
+};
+
+struct LinkedListMoveDequeTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyLinkedList<CountedText>> deque;
+
+	void SetUp() override
+	{
+		CountedText::copies = 0;
+		deque = std::make_unique<MyLinkedList<CountedText>>();
+	}
+
+	void TearDown() override
+	{
+		deque.reset();
+	}
+};
+
+struct ArrayMoveDequeTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyArrayDeque<CountedText>> deque;
+
+	void SetUp() override
+	{
+		CountedText::copies = 0;
+		deque = std::make_unique<MyArrayDeque<CountedText>>();
+	}
+
+	void TearDown() override
+	{
+		deque.reset();
+	}
+};
+
+struct BlockDequeTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<IDeque<int>> deque;
+
+	void SetUp() override
+	{
+		deque = std::make_unique<MyBlockDeque<int>>();
+	}
+
+	void TearDown() override
+	{
+		deque.reset();
+	}
+};
+
+struct BlockMoveDequeTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyBlockDeque<CountedText>> deque;
+
+	void SetUp() override
+	{
+		CountedText::copies = 0;
+		deque = std::make_unique<MyBlockDeque<CountedText>>();
+	}
+
+	void TearDown() override
+	{
+		deque.reset();
+	}
+};
+
 void GivenEmpty_WhenAddingFirst_ShouldBeFirstAndLast(IDeque<int>& deque)
 {
 	deque.add_first(5);
@@ -219,6 +314,81 @@ void GivenCleared_WhenAddingLast_ShouldContain(IDeque<int>& deque)
 	ASSERT_EQ(deque.peek_last(), 2);
 }
 
+void GivenWrappedAround_WhenGrowing_ShouldKeepOrder(IDeque<int>& deque)
+{
+	deque.add_last(3);
+	deque.add_first(2);
+	deque.add_first(1);
+	deque.add_last(4); //full, and the first items sit at the far end of the ring
+	deque.add_last(5);
+	deque.add_first(0);
+
+	for (int expected = 0; expected <= 5; expected++)
+	{
+		ASSERT_EQ(deque.remove_first(), expected);
+	}
+	ASSERT_EQ(deque.get_count(), 0);
+}
+
+void GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder(IDeque<int>& deque)
+{
+	deque.add_last(0);
+	for (int value = 1; value < 100000; value++)
+	{
+		deque.add_last(value);
+		ASSERT_EQ(deque.remove_first(), value - 1);
+	}
+	for (int value = 100000; value < 200000; value++)
+	{
+		deque.add_first(value);
+		ASSERT_EQ(deque.remove_last(), value == 100000 ? 99999 : value - 1);
+	}
+	ASSERT_EQ(deque.get_count(), 1);
+	ASSERT_EQ(deque.peek_first(), 199999);
+}
+
+void WhenTaking_ShouldMoveItemsOutInOrder(IDeque<CountedText>& deque)
+{
+	deque.add_last(CountedText("b"));
+	deque.add_first(CountedText("a"));
+	deque.emplace_last(3, 'c');
+	for (int index = 0; index < 10; index++) //grows the array deque twice
+	{
+		deque.emplace_first("z");
+	}
+
+	ASSERT_EQ(deque.take_last().text, "ccc");
+	ASSERT_EQ(deque.take_last().text, "b");
+	ASSERT_EQ(deque.take_last().text, "a");
+	ASSERT_EQ(deque.take_first().text, "z");
+	ASSERT_EQ(deque.get_count(), 9);
+	ASSERT_EQ(CountedText::copies, 0);
+}
+
+void WhenAddingConst_ShouldCopyOnce(IDeque<CountedText>& deque)
+{
+	const CountedText item("a");
+	deque.add_last(item);
+	deque.add_first(item);
+	ASSERT_EQ(CountedText::copies, 2);
+	ASSERT_EQ(item.text, "a");
+}
+
+void GivenEmpty_WhenTaking_ShouldThrow(IDeque<CountedText>& deque)
+{
+	ASSERT_THROW({ deque.take_first(); }, std::exception);
+	ASSERT_THROW({ deque.take_last(); }, std::exception);
+}
+
+void GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference(IDeque<CountedText>& deque)
+{
+	deque.emplace_last("first");
+	deque.emplace_last("second");
+	const CountedText& removed = deque.remove_first();
+	ASSERT_EQ(removed.text, "first");
+	ASSERT_EQ(deque.remove_first().text, "second");
+}
+
 /*** MyLinkedList ***/
 
 TEST_F(LinkedListDequeTest, GivenEmpty_WhenAddingLast_ShouldBeFirstAndLast)
@@ -311,6 +481,36 @@ TEST_F(LinkedListDequeTest, GivenCleared_WhenAddingLast_ShouldContain)
 	GivenCleared_WhenAddingLast_ShouldContain(*deque);
 }
 
+TEST_F(LinkedListDequeTest, GivenWrappedAround_WhenGrowing_ShouldKeepOrder)
+{
+	GivenWrappedAround_WhenGrowing_ShouldKeepOrder(*deque);
+}
+
+TEST_F(LinkedListDequeTest, GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder)
+{
+	GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder(*deque);
+}
+
+TEST_F(LinkedListMoveDequeTest, WhenTaking_ShouldMoveItemsOutInOrder)
+{
+	WhenTaking_ShouldMoveItemsOutInOrder(*deque);
+}
+
+TEST_F(LinkedListMoveDequeTest, WhenAddingConst_ShouldCopyOnce)
+{
+	WhenAddingConst_ShouldCopyOnce(*deque);
+}
+
+TEST_F(LinkedListMoveDequeTest, GivenEmpty_WhenTaking_ShouldThrow)
+{
+	GivenEmpty_WhenTaking_ShouldThrow(*deque);
+}
+
+TEST_F(LinkedListMoveDequeTest, GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference)
+{
+	GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference(*deque);
+}
+
 /*** MyArrayDeque ***/
 
 TEST_F(ArrayDequeTest, GivenEmpty_WhenAddingLast_ShouldBeFirstAndLast)
@@ -401,4 +601,369 @@ TEST_F(ArrayDequeTest, GivenCleared_WhenAddingFirst_ShouldContain)
 TEST_F(ArrayDequeTest, GivenCleared_WhenAddingLast_ShouldContain)
 {
 	GivenCleared_WhenAddingLast_ShouldContain(*deque);
+}
+
+TEST_F(ArrayDequeTest, GivenWrappedAround_WhenGrowing_ShouldKeepOrder)
+{
+	GivenWrappedAround_WhenGrowing_ShouldKeepOrder(*deque);
+}
+
+TEST_F(ArrayDequeTest, GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder)
+{
+	GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder(*deque);
+}
+
+TEST_F(ArrayMoveDequeTest, WhenTaking_ShouldMoveItemsOutInOrder)
+{
+	WhenTaking_ShouldMoveItemsOutInOrder(*deque);
+}
+
+TEST_F(ArrayMoveDequeTest, WhenAddingConst_ShouldCopyOnce)
+{
+	WhenAddingConst_ShouldCopyOnce(*deque);
+}
+
+TEST_F(ArrayMoveDequeTest, GivenEmpty_WhenTaking_ShouldThrow)
+{
+	GivenEmpty_WhenTaking_ShouldThrow(*deque);
+}
+
+TEST_F(ArrayMoveDequeTest, GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference)
+{
+	GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference(*deque);
+}
+
+TEST_F(ArrayMoveDequeTest, WhenGrowingAndTaking_ShouldOnlyKeepLiveItemsConstructed)
+{
+	for (int index = 0; index < 5; index++) //grows past the first 4 slots
+	{
+		deque->emplace_last("a");
+	}
+	ASSERT_EQ(CountedText::alive, 5);
+
+	deque->take_first();
+	deque->take_last();
+	ASSERT_EQ(CountedText::alive, 3);
+
+	deque->remove_first(); //held on to for the reference it hands out
+	ASSERT_EQ(CountedText::alive, 3);
+
+	deque.reset();
+	ASSERT_EQ(CountedText::alive, 0);
+}
+
+TEST(MyArrayDequeTest, GivenNoDefaultConstructor_WhenGrowingWrappedAround_ShouldKeepOrder)
+{
+	MyArrayDeque<Point> points;
+	points.emplace_last(2, 2);
+	points.emplace_first(1, 1);
+	points.emplace_first(0, 0);
+	points.emplace_last(3, 3);
+	points.emplace_last(4, 4); //grows with the items wrapped, so both runs are copied
+
+	for (int expected = 0; expected < 5; expected++)
+	{
+		const Point point = points.take_first();
+		ASSERT_EQ(point.x, expected);
+		ASSERT_EQ(point.y, expected);
+	}
+}
+
+TEST(MyArrayDequeTest, GivenMoveMayThrow_WhenCopyThrowsWhileGrowing_ShouldLeaveDequeAsItWas)
+{
+	struct Fussy
+	{
+		std::shared_ptr<int> token;
+		int* copies_left;
+
+		Fussy(std::shared_ptr<int> from, int* budget) : token(std::move(from)), copies_left(budget) {}
+		Fussy(const Fussy& other) : token(other.token), copies_left(other.copies_left)
+		{
+			if ((*copies_left)-- == 0) throw std::exception("copy failed");
+		}
+		Fussy(Fussy&& other) : token(std::move(other.token)), copies_left(other.copies_left) {} //not noexcept
+	};
+
+	auto token = std::make_shared<int>(1);
+	int copies_left = 0;
+	{
+		MyArrayDeque<Fussy> items;
+		for (int item = 0; item < 4; item++)
+		{
+			items.emplace_first(token, &copies_left);
+		}
+
+		copies_left = 2; //two of the four items get across before the third copy throws
+		ASSERT_THROW(items.emplace_last(token, &copies_left), std::exception);
+		ASSERT_EQ(items.get_count(), 4);
+		ASSERT_EQ(token.use_count(), 5);
+		for (int index = 0; index < 4; index++)
+		{
+			ASSERT_EQ(items.peek_first().token, token); //copied from, never moved from
+			items.add_last(items.take_first());
+		}
+
+		const Fussy more[] = { Fussy(token, &copies_left) };
+		copies_left = 2;
+		ASSERT_THROW(items.add_last_range(more, 1), std::exception);
+		ASSERT_EQ(items.get_count(), 4);
+		ASSERT_EQ(token.use_count(), 6);
+	}
+	ASSERT_EQ(token.use_count(), 1);
+}
+
+TEST(MyArrayDequeTest, GivenWrappedItems_WhenAddingRange_ShouldAppendInOrder)
+{
+	MyArrayDeque<int> numbers;
+	numbers.add_last(-1);
+	numbers.add_last(0);
+	numbers.add_last(1);
+	numbers.take_first(); //the next free slot is the last, so the range wraps
+	const int fits[] = { 2, 3 };
+	numbers.add_last_range(fits, 2);
+	const int grows[] = { 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+	numbers.add_last_range(grows, 9);
+
+	ASSERT_EQ(numbers.get_count(), 13);
+	for (int expected = 0; expected < 13; expected++)
+	{
+		ASSERT_EQ(numbers.take_first(), expected);
+	}
+}
+
+TEST_F(ArrayMoveDequeTest, WhenRemovingFirstN_ShouldMoveOutAtMostCount)
+{
+	deque->emplace_first("b");
+	deque->emplace_first("a");
+	const CountedText more[] = { "c", "d", "e" };
+	deque->add_last_range(more, 3);
+	ASSERT_EQ(CountedText::copies, 3);
+
+	CountedText out[4];
+	ASSERT_EQ(deque->remove_first_n(out, 3), 3);
+	ASSERT_EQ(out[0].text + out[1].text + out[2].text, "abc");
+	ASSERT_EQ(deque->remove_first_n(out, 4), 2);
+	ASSERT_EQ(out[0].text + out[1].text, "de");
+	ASSERT_EQ(deque->remove_first_n(out, 4), 0);
+	ASSERT_EQ(CountedText::copies, 3);
+	ASSERT_EQ(CountedText::alive, 7); //the inputs and outputs, nothing left in the deque
+}
+
+TEST_F(ArrayMoveDequeTest, GivenNegativeCount_WhenAddingRangeOrRemovingFirstN_ShouldThrow)
+{
+	deque->emplace_last("a");
+	const CountedText more[] = { "b" };
+	CountedText out[1];
+	ASSERT_THROW(deque->add_last_range(more, -1), std::exception);
+	ASSERT_THROW(deque->remove_first_n(out, -1), std::exception);
+	ASSERT_EQ(deque->get_count(), 1);
+}
+
+TEST(MyArrayDequeTest, WhenGettingContiguousSpans_ShouldCoverItemsInOrder)
+{
+	MyArrayDeque<int> numbers;
+	auto [first, second] = numbers.contiguous_spans();
+	ASSERT_EQ(first.count + second.count, 0);
+
+	numbers.add_last(2);
+	numbers.add_first(1);
+	numbers.add_first(0);
+	std::tie(first, second) = numbers.contiguous_spans();
+	ASSERT_EQ(first.count, 2);
+	ASSERT_EQ(second.count, 1);
+	ASSERT_EQ(first.data[0], 0);
+	ASSERT_EQ(first.data[1], 1);
+	ASSERT_EQ(second.data[0], 2);
+
+	numbers.take_first();
+	numbers.take_first();
+	std::tie(first, second) = numbers.contiguous_spans();
+	ASSERT_EQ(first.count, 1);
+	ASSERT_EQ(second.count, 0);
+	ASSERT_EQ(first.data[0], 2);
+}
+
+/*** MyBlockDeque ***/
+
+TEST_F(BlockDequeTest, GivenEmpty_WhenAddingLast_ShouldBeFirstAndLast)
+{
+	GivenEmpty_WhenAddingLast_ShouldBeFirstAndLast(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenAddingLast_ShouldIncreaseCount)
+{
+	WhenAddingLast_ShouldIncreaseCount(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenAddingFirst_ShouldBeLast)
+{
+	WhenAddingFirst_ShouldBeLast(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenRemovingLast_ShouldRemoveReverseInOrder)
+{
+	WhenRemovingLast_ShouldRemoveReverseInOrder(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenRemovingLast_ShouldDecreaseCount)
+{
+	WhenRemovingLast_ShouldDecreaseCount(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenSize2_WhenRemovingLast_ShouldHaveEqualFirstAndLast)
+{
+	GivenSize2_WhenRemovingLast_ShouldHaveEqualFirstAndLast(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenEmpty_WhenRemovingLast_ShouldThrow)
+{
+	GivenEmpty_WhenRemovingLast_ShouldThrow(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenEmpty_WhenPeekingLast_ShouldThrow)
+{
+	GivenEmpty_WhenPeekingLast_ShouldThrow(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenEmpty_WhenAddingFirst_ShouldBeFirstAndLast)
+{
+	GivenEmpty_WhenAddingFirst_ShouldBeFirstAndLast(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenAddingFirst_ShouldIncreaseCount)
+{
+	WhenAddingFirst_ShouldIncreaseCount(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenAddingFirst_ShouldBeFirst)
+{
+	WhenAddingFirst_ShouldBeFirst(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenRemovingFirst_ShouldRemoveInOrder)
+{
+	WhenRemovingFirst_ShouldRemoveInOrder(*deque);
+}
+
+TEST_F(BlockDequeTest, WhenRemovingFirst_ShouldDecreaseCount)
+{
+	WhenRemovingFirst_ShouldDecreaseCount(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenSize2_WhenRemovingFirst_ShouldHaveEqualFirstAndLast)
+{
+	GivenSize2_WhenRemovingFirst_ShouldHaveEqualFirstAndLast(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenEmpty_WhenRemovingFirst_ShouldThrow)
+{
+	GivenEmpty_WhenRemovingFirst_ShouldThrow(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenEmpty_WhenPeekingFirst_ShouldThrow)
+{
+	GivenEmpty_WhenPeekingFirst_ShouldThrow(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenCleared_WhenAddingFirst_ShouldContain)
+{
+	GivenCleared_WhenAddingFirst_ShouldContain(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenCleared_WhenAddingLast_ShouldContain)
+{
+	GivenCleared_WhenAddingLast_ShouldContain(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenWrappedAround_WhenGrowing_ShouldKeepOrder)
+{
+	GivenWrappedAround_WhenGrowing_ShouldKeepOrder(*deque);
+}
+
+TEST_F(BlockDequeTest, GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder)
+{
+	GivenManyPasses_WhenAddingAndRemoving_ShouldKeepOrder(*deque);
+}
+
+TEST_F(BlockMoveDequeTest, WhenTaking_ShouldMoveItemsOutInOrder)
+{
+	WhenTaking_ShouldMoveItemsOutInOrder(*deque);
+}
+
+TEST_F(BlockMoveDequeTest, WhenAddingConst_ShouldCopyOnce)
+{
+	WhenAddingConst_ShouldCopyOnce(*deque);
+}
+
+TEST_F(BlockMoveDequeTest, GivenEmpty_WhenTaking_ShouldThrow)
+{
+	GivenEmpty_WhenTaking_ShouldThrow(*deque);
+}
+
+TEST_F(BlockMoveDequeTest, GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference)
+{
+	GivenTwoItems_WhenRemovingFirst_ShouldReturnUsableReference(*deque);
+}
+
+TEST_F(BlockMoveDequeTest, WhenSpanningManyBlocks_ShouldOnlyKeepLiveItemsConstructed)
+{
+	for (int index = 0; index < 1000; index++)
+	{
+		deque->emplace_last("a");
+		deque->emplace_first("b");
+	}
+	ASSERT_EQ(CountedText::alive, 2000);
+
+	for (int index = 0; index < 700; index++)
+	{
+		deque->take_first();
+		deque->take_last();
+	}
+	ASSERT_EQ(CountedText::alive, 600);
+	ASSERT_EQ((*deque)[0].text, "b");
+	ASSERT_EQ((*deque)[599].text, "a");
+
+	deque.reset();
+	ASSERT_EQ(CountedText::alive, 0);
+}
+
+TEST(MyBlockDequeTest, WhenGrowing_ShouldKeepItemsWhereTheyAre)
+{
+	MyBlockDeque<int> numbers;
+	numbers.add_last(0);
+	const int* first = &numbers.peek_first();
+	for (int value = 1; value < 100000; value++)
+	{
+		numbers.add_last(value);
+		numbers.add_first(-value); //grows from both ends past many blocks and map doublings
+	}
+
+	ASSERT_EQ(&numbers[99999], first);
+	for (int index = 0; index < numbers.get_count(); index++)
+	{
+		ASSERT_EQ(numbers[index], index - 99999);
+	}
+	ASSERT_THROW(numbers[-1], std::exception);
+	ASSERT_THROW(numbers[numbers.get_count()], std::exception);
+}
+
+TEST(MyBlockDequeTest, GivenConstructorThrows_WhenAdding_ShouldLeaveDequeAsItWas)
+{
+	struct Fussy
+	{
+		int value;
+		explicit Fussy(int from) : value(from)
+		{
+			if (from < 0) throw std::exception("negative");
+		}
+	};
+
+	MyBlockDeque<Fussy> items;
+	ASSERT_THROW(items.emplace_last(-1), std::exception);
+	ASSERT_EQ(items.get_count(), 0);
+	items.emplace_last(1);
+	ASSERT_THROW(items.emplace_first(-1), std::exception);
+	items.emplace_first(0);
+	ASSERT_EQ(items.take_first().value, 0);
+	ASSERT_EQ(items.take_first().value, 1);
 }
\ No newline at end of file
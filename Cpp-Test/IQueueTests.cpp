@@ -33,6 +33,38 @@ protected:
 	}
 };
 
+struct BlockDequeQueueTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<IQueue<int>> queue;
+
+	void SetUp() override
+	{
+		queue = std::make_unique<MyBlockDeque<int>>();
+	}
+
+	void TearDown() override
+	{
+		queue.reset();
+	}
+};
+
+struct MpmcQueueTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<IQueue<int>> queue;
+
+	void SetUp() override
+	{
+		queue = std::make_unique<MyMpmcQueue<int>>(16);
+	}
+
+	void TearDown() override
+	{
+		queue.reset();
+	}
+};
+
 void WhenOffering_ShouldIncreaseCount(IQueue<int>& queue)
 {
 	ASSERT_EQ(queue.get_count(), 0);
@@ -179,3 +211,77 @@ TEST_F(ArrayDequeQueueTest, GivenCleared_WhenOffering_ShouldContain)
 {
 	GivenCleared_WhenOffering_ShouldContain(*queue);
 }
+
+/*** MyBlockDeque ***/
+
+TEST_F(BlockDequeQueueTest, WhenOffering_ShouldIncreaseCount)
+{
+	WhenOffering_ShouldIncreaseCount(*queue);
+}
+
+TEST_F(BlockDequeQueueTest, WhenPolling_ShouldRemoveThemInFifoOrder)
+{
+	WhenPolling_ShouldRemoveThemInFifoOrder(*queue);
+}
+
+TEST_F(BlockDequeQueueTest, WhenPolling_ShouldDecreaseCount)
+{
+	WhenPolling_ShouldDecreaseCount(*queue);
+}
+
+TEST_F(BlockDequeQueueTest, WhenPollingEmpty_ShouldThrow)
+{
+	WhenPollingEmpty_ShouldThrow(*queue);
+}
+
+TEST_F(BlockDequeQueueTest, WhenPeekingEmpty_ShouldThrow)
+{
+	WhenPeekingEmpty_ShouldThrow(*queue);
+}
+
+TEST_F(BlockDequeQueueTest, WhenPeeking_ShouldReturnNext)
+{
+	WhenPeeking_ShouldReturnNext(*queue);
+}
+
+TEST_F(BlockDequeQueueTest, GivenCleared_WhenOffering_ShouldContain)
+{
+	GivenCleared_WhenOffering_ShouldContain(*queue);
+}
+
+/*** MyMpmcQueue ***/
+
+TEST_F(MpmcQueueTest, WhenOffering_ShouldIncreaseCount)
+{
+	WhenOffering_ShouldIncreaseCount(*queue);
+}
+
+TEST_F(MpmcQueueTest, WhenPolling_ShouldRemoveThemInFifoOrder)
+{
+	WhenPolling_ShouldRemoveThemInFifoOrder(*queue);
+}
+
+TEST_F(MpmcQueueTest, WhenPolling_ShouldDecreaseCount)
+{
+	WhenPolling_ShouldDecreaseCount(*queue);
+}
+
+TEST_F(MpmcQueueTest, WhenPollingEmpty_ShouldThrow)
+{
+	WhenPollingEmpty_ShouldThrow(*queue);
+}
+
+TEST_F(MpmcQueueTest, WhenPeekingEmpty_ShouldThrow)
+{
+	WhenPeekingEmpty_ShouldThrow(*queue);
+}
+
+TEST_F(MpmcQueueTest, WhenPeeking_ShouldReturnNext)
+{
+	WhenPeeking_ShouldReturnNext(*queue);
+}
+
+TEST_F(MpmcQueueTest, GivenCleared_WhenOffering_ShouldContain)
+{
+	GivenCleared_WhenOffering_ShouldContain(*queue);
+}
\ No newline at end of file
@@ -33,6 +33,22 @@ protected:
 	}
 };
 
+struct BlockDequeStackTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<IStack<int>> stack;
+
+	void SetUp() override
+	{
+		stack = std::make_unique<MyBlockDeque<int>>();
+	}
+
+	void TearDown() override
+	{
+		stack.reset();
+	}
+};
+
 void WhenPushing_ShouldIncreaseCount(IStack<int>& stack)
 {
 	ASSERT_EQ(stack.get_count(), 0);
@@ -178,6 +194,43 @@ TEST_F(ArrayDequeStackTest, WhenPoppingEmpty_ShouldThrow)
 }
 
 TEST_F(ArrayDequeStackTest, GivenCleared_WhenPopped_ShouldContain)
+{
+	GivenCleared_WhenPushed_ShouldContain(*stack);
+}
+
+/*** MyBlockDeque ***/
+
+TEST_F(BlockDequeStackTest, WhenPushing_ShouldIncreaseCount)
+{
+	WhenPushing_ShouldIncreaseCount(*stack);
+}
+
+TEST_F(BlockDequeStackTest, WhenPeeking_ShouldBeLastPushed)
+{
+	WhenPeeking_ShouldBeLastPushed(*stack);
+}
+
+TEST_F(BlockDequeStackTest, WhenPopping_ShouldRemoveThemInFiloOrder)
+{
+	WhenPopping_ShouldRemoveThemInFiloOrder(*stack);
+}
+
+TEST_F(BlockDequeStackTest, WhenPopping_ShouldDecreaseCount)
+{
+	WhenPopping_ShouldDecreaseCount(*stack);
+}
+
+TEST_F(BlockDequeStackTest, WhenPeekingEmpty_ShouldThrow)
+{
+	WhenPeekingEmpty_ShouldThrow(*stack);
+}
+
+TEST_F(BlockDequeStackTest, WhenPoppingEmpty_ShouldThrow)
+{
+	WhenPoppingEmpty_ShouldThrow(*stack);
+}
+
+TEST_F(BlockDequeStackTest, GivenCleared_WhenPopped_ShouldContain)
 {
 	GivenCleared_WhenPushed_ShouldContain(*stack);
 }
\ No newline at end of file
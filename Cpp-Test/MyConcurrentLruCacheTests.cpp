@@ -0,0 +1,529 @@
+#include "pch.h"
+
+using namespace ds;
+
+constexpr size_t TEST_SHARD_COUNT = 4;
+
+struct MyConcurrentLruCacheTest : public Test
+{
+	std::unique_ptr<MyConcurrentLruCache<int, string>> lru_cache_;
+
+	void SetUp() override
+	{
+		lru_cache_ = make_unique<MyConcurrentLruCache<int, string>>(TEST_SHARD_COUNT);
+	}
+
+	void TearDown() override
+	{
+		lru_cache_.reset();
+	}
+};
+
+void GivenEmpty_WhenPutting_ShouldBeInLru(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	string five = "five";
+	lru.put(5, five);
+	ASSERT_TRUE(lru.contains(5));
+	ASSERT_EQ(lru.get(5), five);
+}
+
+void GivenItemNotInLru_WhenTryGetting_ShouldReturnFalse(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	string five = "five";
+	lru.put(5, five);
+
+	string result;
+	ASSERT_FALSE(lru.try_get(2, result));
+	ASSERT_TRUE(lru.try_get(5, result));
+	ASSERT_EQ(result, five);
+}
+
+void GivenItemNotInLru_WhenGetting_ShouldThrow(MyConcurrentLruCache<int, string>& lru)
+{
+	ASSERT_THROW({ lru.get(2); }, std::exception);
+	ASSERT_THROW({ lru.remove(2); }, std::exception);
+}
+
+void WhenShardCountNotPowerOfTwo_ShouldRoundUp(MyConcurrentLruCache<int, string>&)
+{
+	MyConcurrentLruCache<int, string> lru(3);
+	ASSERT_EQ(lru.get_shard_count(), 4);
+}
+
+void WhenOverfilling_ShouldNeverExceedCapacity(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(10);
+	string value = "value";
+	for (int key = 0; key < 1000; key++)
+	{
+		lru.put(key, value);
+		ASSERT_LE(lru.size(), 10);
+	}
+	ASSERT_EQ(lru.get_capacity(), 10);
+}
+
+void GivenFull_WhenCapacityShrunk_ShouldShrinkEveryShard(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(100);
+	string value = "value";
+	for (int key = 0; key < 1000; key++)
+	{
+		lru.put(key, value);
+	}
+
+	lru.set_capacity(0);
+	ASSERT_TRUE(lru.is_empty());
+}
+
+void WhenPuttingFromManyThreads_ShouldKeepEveryKey(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(1 << 16);
+	std::vector<std::thread> threads;
+	for (int thread_index = 0; thread_index < 8; thread_index++)
+	{
+		threads.emplace_back([&lru, thread_index]
+		{
+			for (int index = 0; index < 1000; index++)
+			{
+				int key = thread_index * 1000 + index;
+				string value = std::to_string(key);
+				lru.put(key, value);
+				lru.get(key);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(lru.size(), 8000);
+	ASSERT_EQ(lru.get(4321), "4321");
+}
+
+void GivenNonEmpty_WhenClearing_ShouldBeEmpty(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	string one = "one";
+	string two = "two";
+	lru.put(1, one);
+	lru.put(2, two);
+	ASSERT_FALSE(lru.is_empty());
+
+	lru.clear();
+	ASSERT_TRUE(lru.is_empty());
+}
+
+void GivenDrainThresholdOne_WhenGetting_ShouldBeMostRecentlyUsed(MyConcurrentLruCache<int, string>&)
+{
+	MyConcurrentLruCache<int, string> lru(1);
+	lru.set_capacity(2);
+	lru.set_drain_threshold(1);
+	string one = "one";
+	string two = "two";
+	lru.put(1, one);
+	lru.put(2, two);
+
+	ASSERT_EQ(lru.get(1), one);
+
+	string three = "three";
+	lru.put(3, three);
+	ASSERT_TRUE(lru.contains(1));
+	ASSERT_FALSE(lru.contains(2));
+	ASSERT_TRUE(lru.contains(3));
+}
+
+void GivenBufferedReads_WhenPutting_ShouldApplyThemBeforeEvicting(MyConcurrentLruCache<int, string>&)
+{
+	MyConcurrentLruCache<int, string> lru(1);
+	lru.set_capacity(2);
+	lru.set_drain_threshold(READ_BUFFER_SIZE);
+	string one = "one";
+	string two = "two";
+	lru.put(1, one);
+	lru.put(2, two);
+
+	lru.get(1); //only buffered, the threshold hasn't been reached
+
+	string three = "three";
+	lru.put(3, three);
+	ASSERT_TRUE(lru.contains(1));
+	ASSERT_FALSE(lru.contains(2));
+	ASSERT_TRUE(lru.contains(3));
+}
+
+void WhenDrainThresholdLargerThanBuffer_ShouldThrow(MyConcurrentLruCache<int, string>& lru)
+{
+	ASSERT_THROW({ lru.set_drain_threshold(READ_BUFFER_SIZE + 1); }, std::exception);
+	ASSERT_EQ(lru.get_drain_threshold(), 0);
+}
+
+void GivenBufferedReads_WhenGettingFromManyThreads_ShouldGetEveryValue(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(1 << 12);
+	lru.set_drain_threshold(READ_BUFFER_SIZE / 2);
+	for (int key = 0; key < 1000; key++)
+	{
+		string value = std::to_string(key);
+		lru.put(key, value);
+	}
+
+	std::atomic<int> wrong = 0;
+	std::vector<std::thread> threads;
+	for (int thread_index = 0; thread_index < 8; thread_index++)
+	{
+		threads.emplace_back([&lru, &wrong]
+		{
+			for (int repeat = 0; repeat < 10; repeat++)
+			{
+				for (int key = 0; key < 1000; key++)
+				{
+					if (lru.get(key) != std::to_string(key)) ++wrong;
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(wrong, 0);
+	ASSERT_EQ(lru.size(), 1000);
+}
+
+void GivenTimeToLive_WhenTimeIsUp_ShouldNotBeInAnyShard(MyConcurrentLruCache<int, string>& lru)
+{
+	std::atomic<uint64_t> now = 1000;
+	lru.set_time_source([&now]() { return now.load(); });
+	lru.set_capacity(64);
+	lru.set_drain_threshold(4);
+	string value = "value";
+	for (int key = 0; key < 32; key++)
+	{
+		lru.put(key, value, std::chrono::milliseconds(key < 16 ? 10 : 1000));
+	}
+
+	now += 10;
+	string result;
+	ASSERT_FALSE(lru.contains(3));
+	ASSERT_FALSE(lru.try_get(3, result));
+	ASSERT_TRUE(lru.try_get(20, result));
+
+	ASSERT_EQ(lru.remove_expired(), 16);
+	ASSERT_EQ(lru.size(), 16);
+}
+
+void GivenManyThreadsMissingOneKey_WhenGettingOrLoading_ShouldLoadOnce(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	std::atomic<int> loads = 0;
+	std::atomic<bool> release = false;
+	auto loader = [&loads, &release](const int& key)
+	{
+		++loads;
+		while (!release.load())
+		{
+			std::this_thread::yield();
+		}
+		return std::to_string(key);
+	};
+
+	std::vector<std::thread> threads;
+	std::vector<string> results(8);
+	for (int thread_index = 0; thread_index < 8; thread_index++)
+	{
+		threads.emplace_back([&lru, &loader, &results, thread_index]
+		{
+			results[thread_index] = lru.get_or_load(42, loader);
+		});
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	release = true;
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(loads.load(), 1);
+	for (const string& result : results)
+	{
+		ASSERT_EQ(result, "42");
+	}
+	ASSERT_EQ(lru.get(42), "42");
+}
+
+void GivenLoaderThrows_WhenGettingOrLoading_ShouldNotCacheAndRetryNextTime(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	auto failing = [](const int&) -> string { throw std::exception("backend down"); };
+	ASSERT_THROW(lru.get_or_load(7, failing), std::exception);
+	ASSERT_FALSE(lru.contains(7));
+
+	ASSERT_EQ(lru.get_or_load(7, [](const int&) { return string("seven"); }), "seven");
+	ASSERT_TRUE(lru.contains(7));
+}
+
+void GivenNoDefaultConstructor_WhenGettingOrLoading_ShouldLoadAndCache(MyConcurrentLruCache<int, string>&)
+{
+	struct Reading
+	{
+		explicit Reading(int celsius) : celsius(celsius) {}
+		int celsius;
+	};
+	MyConcurrentLruCache<int, Reading> cache(4);
+	ASSERT_EQ(cache.get_or_load(1, [](const int& key) { return Reading(key * 10); }).celsius, 10);
+	ASSERT_EQ(cache.get_or_load(1, [](const int&) { return Reading(0); }).celsius, 10);
+	ASSERT_EQ(cache.get(1).celsius, 10);
+	ASSERT_THROW(cache.get(2), std::exception);
+}
+
+void GivenPutWhileLoading_WhenLoadFinishes_ShouldKeepPutValue(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	std::atomic<bool> loading = false;
+	std::atomic<bool> release = false;
+	string loaded;
+	std::thread loader_thread([&]
+	{
+		loaded = lru.get_or_load(3, [&](const int&)
+		{
+			loading = true;
+			while (!release.load())
+			{
+				std::this_thread::yield();
+			}
+			return string("stale");
+		});
+	});
+	while (!loading.load())
+	{
+		std::this_thread::yield();
+	}
+	string fresh = "fresh";
+	lru.put(3, fresh);
+	release = true;
+	loader_thread.join();
+
+	ASSERT_EQ(loaded, "stale");
+	ASSERT_EQ(lru.get(3), "fresh");
+}
+
+void GivenBufferedReads_WhenGettingStats_ShouldCountEveryLookup(MyConcurrentLruCache<int, string>&)
+{
+	MyConcurrentLruCache<int, string, LruPolicy, CacheStats> lru(TEST_SHARD_COUNT);
+	lru.set_capacity(64);
+	string value = "value";
+	for (int key = 0; key < 32; key++)
+	{
+		lru.put(key, value);
+	}
+
+	string result;
+	lru.try_get(1, result);
+	lru.set_drain_threshold(8);
+	for (int key = 0; key < 40; key++)
+	{
+		lru.try_get(key, result);
+	}
+
+	CacheStatsSnapshot stats = lru.get_stats();
+	ASSERT_EQ(stats.puts, 32);
+	ASSERT_EQ(stats.hits, 33); //drained reads aren't counted twice
+	ASSERT_EQ(stats.misses, 8);
+	ASSERT_EQ(stats.weight, 32);
+}
+
+void WhenPuttingAndGettingMany_ShouldMatchKeysAcrossShards(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(256);
+	std::vector<int> keys;
+	std::vector<string> values;
+	for (int key = 0; key < 100; key++)
+	{
+		keys.push_back(key);
+		values.push_back(std::to_string(key));
+	}
+	lru.put_many(keys, values);
+	ASSERT_EQ(lru.size(), 100);
+
+	for (size_t drain_threshold : { static_cast<size_t>(0), static_cast<size_t>(4) })
+	{
+		lru.set_drain_threshold(drain_threshold);
+		std::vector<int> lookups = { 99, 500, 0, 42, 501, 42 };
+		std::vector<string> results;
+		std::vector<bool> found;
+		ASSERT_EQ(lru.get_many(lookups, results, found), 4);
+		ASSERT_EQ(found, (std::vector<bool>{ true, false, true, true, false, true }));
+		ASSERT_EQ(results[0], "99");
+		ASSERT_EQ(results[2], "0");
+		ASSERT_EQ(results[3], "42");
+		ASSERT_EQ(results[5], "42");
+	}
+}
+
+void WhenPuttingRvalueAndEmplacing_ShouldBeInLru(MyConcurrentLruCache<int, string>& lru)
+{
+	lru.set_capacity(16);
+	lru.put(1, string("one"));
+	int two = 2;
+	lru.put(two, string("two"));
+	lru.emplace(3, 5, 'x');
+
+	ASSERT_EQ(lru.get(1), "one");
+	ASSERT_EQ(lru.get(2), "two");
+	ASSERT_EQ(lru.get(3), "xxxxx");
+}
+
+void GivenStringKeys_WhenLookingUpByStringView_ShouldFindInItsShard(MyConcurrentLruCache<int, string>&)
+{
+	MyConcurrentLruCache<string, int> lru(TEST_SHARD_COUNT);
+	lru.set_capacity(1024);
+	for (int key = 0; key < 64; key++)
+	{
+		lru.put("request/" + std::to_string(key), key);
+	}
+
+	for (size_t drain_threshold : { static_cast<size_t>(0), static_cast<size_t>(4) })
+	{
+		lru.set_drain_threshold(drain_threshold);
+		const string request = "GET request/42 HTTP/1.1";
+		const std::string_view key = std::string_view(request).substr(4, 10);
+		int value = 0;
+		ASSERT_TRUE(lru.try_get(key, value));
+		ASSERT_EQ(value, 42);
+		ASSERT_EQ(lru.get(key), 42);
+		ASSERT_TRUE(lru.contains("request/7"));
+		ASSERT_FALSE(lru.contains(key.substr(1)));
+	}
+}
+
+void GivenRemovalListener_WhenEvicting_ShouldRunOutsideShardLock(MyConcurrentLruCache<int, string>&)
+{
+	MyConcurrentLruCache<int, string> lru(1);
+	lru.set_capacity(2);
+	std::vector<int> removed;
+	lru.set_removal_listener([&lru, &removed](int&& key, string&&, RemovalCause)
+	{
+		ASSERT_FALSE(lru.contains(key)); //takes the shard's lock, so this would deadlock under it
+		removed.push_back(key);
+	});
+	lru.put(1, string("one"));
+	lru.put(2, string("two"));
+	lru.put(3, string("three"));
+	lru.remove(2);
+
+	ASSERT_EQ(removed, (std::vector<int>{ 1, 2 }));
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenEmpty_WhenPutting_ShouldBeInLru)
+{
+	GivenEmpty_WhenPutting_ShouldBeInLru(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenItemNotInLru_WhenTryGetting_ShouldReturnFalse)
+{
+	GivenItemNotInLru_WhenTryGetting_ShouldReturnFalse(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenItemNotInLru_WhenGetting_ShouldThrow)
+{
+	GivenItemNotInLru_WhenGetting_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, WhenShardCountNotPowerOfTwo_ShouldRoundUp)
+{
+	WhenShardCountNotPowerOfTwo_ShouldRoundUp(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, WhenOverfilling_ShouldNeverExceedCapacity)
+{
+	WhenOverfilling_ShouldNeverExceedCapacity(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenFull_WhenCapacityShrunk_ShouldShrinkEveryShard)
+{
+	GivenFull_WhenCapacityShrunk_ShouldShrinkEveryShard(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, WhenPuttingFromManyThreads_ShouldKeepEveryKey)
+{
+	WhenPuttingFromManyThreads_ShouldKeepEveryKey(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenNonEmpty_WhenClearing_ShouldBeEmpty)
+{
+	GivenNonEmpty_WhenClearing_ShouldBeEmpty(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenDrainThresholdOne_WhenGetting_ShouldBeMostRecentlyUsed)
+{
+	GivenDrainThresholdOne_WhenGetting_ShouldBeMostRecentlyUsed(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenBufferedReads_WhenPutting_ShouldApplyThemBeforeEvicting)
+{
+	GivenBufferedReads_WhenPutting_ShouldApplyThemBeforeEvicting(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, WhenDrainThresholdLargerThanBuffer_ShouldThrow)
+{
+	WhenDrainThresholdLargerThanBuffer_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenBufferedReads_WhenGettingFromManyThreads_ShouldGetEveryValue)
+{
+	GivenBufferedReads_WhenGettingFromManyThreads_ShouldGetEveryValue(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenTimeToLive_WhenTimeIsUp_ShouldNotBeInAnyShard)
+{
+	GivenTimeToLive_WhenTimeIsUp_ShouldNotBeInAnyShard(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenManyThreadsMissingOneKey_WhenGettingOrLoading_ShouldLoadOnce)
+{
+	GivenManyThreadsMissingOneKey_WhenGettingOrLoading_ShouldLoadOnce(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenLoaderThrows_WhenGettingOrLoading_ShouldNotCacheAndRetryNextTime)
+{
+	GivenLoaderThrows_WhenGettingOrLoading_ShouldNotCacheAndRetryNextTime(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenNoDefaultConstructor_WhenGettingOrLoading_ShouldLoadAndCache)
+{
+	GivenNoDefaultConstructor_WhenGettingOrLoading_ShouldLoadAndCache(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenPutWhileLoading_WhenLoadFinishes_ShouldKeepPutValue)
+{
+	GivenPutWhileLoading_WhenLoadFinishes_ShouldKeepPutValue(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenBufferedReads_WhenGettingStats_ShouldCountEveryLookup)
+{
+	GivenBufferedReads_WhenGettingStats_ShouldCountEveryLookup(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, WhenPuttingAndGettingMany_ShouldMatchKeysAcrossShards)
+{
+	WhenPuttingAndGettingMany_ShouldMatchKeysAcrossShards(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, WhenPuttingRvalueAndEmplacing_ShouldBeInLru)
+{
+	WhenPuttingRvalueAndEmplacing_ShouldBeInLru(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenStringKeys_WhenLookingUpByStringView_ShouldFindInItsShard)
+{
+	GivenStringKeys_WhenLookingUpByStringView_ShouldFindInItsShard(*lru_cache_);
+}
+
+TEST_F(MyConcurrentLruCacheTest, GivenRemovalListener_WhenEvicting_ShouldRunOutsideShardLock)
+{
+	GivenRemovalListener_WhenEvicting_ShouldRunOutsideShardLock(*lru_cache_);
+}
@@ -0,0 +1,113 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct MyCountMinSketchTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyCountMinSketch> sketch;
+
+	void SetUp() override
+	{
+		sketch = std::make_unique<MyCountMinSketch>();
+		sketch->ensure_capacity(512);
+	}
+
+	void TearDown() override
+	{
+		sketch.reset();
+	}
+};
+
+void WhenIncrementing_ShouldIncreaseFrequency(MyCountMinSketch& sketch)
+{
+	ASSERT_EQ(sketch.frequency(42), 0);
+
+	sketch.increment(42);
+	ASSERT_EQ(sketch.frequency(42), 1);
+
+	sketch.increment(42);
+	sketch.increment(42);
+	ASSERT_EQ(sketch.frequency(42), 3);
+}
+
+void WhenIncrementingPastFifteen_ShouldSaturate(MyCountMinSketch& sketch)
+{
+	for (int repeat = 0; repeat < 40; repeat++)
+	{
+		sketch.increment(7);
+	}
+	ASSERT_EQ(sketch.frequency(7), 15);
+}
+
+void GivenManyKeys_WhenIncrementing_ShouldNeverUnderCount(MyCountMinSketch& sketch)
+{
+	for (uint64_t key = 0; key < 256; key++)
+	{
+		sketch.increment(key);
+	}
+	for (uint64_t key = 0; key < 256; key++)
+	{
+		ASSERT_GE(sketch.frequency(key), 1);
+	}
+}
+
+void WhenSampleSizeReached_ShouldHalveFrequencies(MyCountMinSketch& sketch)
+{
+	for (int repeat = 0; repeat < 8; repeat++)
+	{
+		sketch.increment(1);
+	}
+	ASSERT_EQ(sketch.frequency(1), 8);
+
+	for (uint64_t key = 1000; sketch.frequency(1) == 8; key++)
+	{
+		sketch.increment(key);
+	}
+	ASSERT_EQ(sketch.frequency(1), 4);
+}
+
+void WhenClearing_ShouldForgetFrequencies(MyCountMinSketch& sketch)
+{
+	sketch.increment(3);
+	sketch.increment(3);
+	sketch.clear();
+	ASSERT_EQ(sketch.frequency(3), 0);
+}
+
+void GivenNoCapacity_WhenIncrementing_ShouldDoNothing(MyCountMinSketch&)
+{
+	MyCountMinSketch empty;
+	empty.increment(3);
+	ASSERT_EQ(empty.frequency(3), 0);
+}
+
+TEST_F(MyCountMinSketchTest, WhenIncrementing_ShouldIncreaseFrequency)
+{
+	WhenIncrementing_ShouldIncreaseFrequency(*sketch);
+}
+
+TEST_F(MyCountMinSketchTest, WhenIncrementingPastFifteen_ShouldSaturate)
+{
+	WhenIncrementingPastFifteen_ShouldSaturate(*sketch);
+}
+
+TEST_F(MyCountMinSketchTest, GivenManyKeys_WhenIncrementing_ShouldNeverUnderCount)
+{
+	GivenManyKeys_WhenIncrementing_ShouldNeverUnderCount(*sketch);
+}
+
+TEST_F(MyCountMinSketchTest, WhenSampleSizeReached_ShouldHalveFrequencies)
+{
+	WhenSampleSizeReached_ShouldHalveFrequencies(*sketch);
+}
+
+TEST_F(MyCountMinSketchTest, WhenClearing_ShouldForgetFrequencies)
+{
+	WhenClearing_ShouldForgetFrequencies(*sketch);
+}
+
+TEST_F(MyCountMinSketchTest, GivenNoCapacity_WhenIncrementing_ShouldDoNothing)
+{
+	GivenNoCapacity_WhenIncrementing_ShouldDoNothing(*sketch);
+}
@@ -0,0 +1,172 @@
+#include "pch.h"
+
+using namespace ds;
+
+//sends every key to the same place so lookups have to probe past each other
+struct ConstantHash
+{
+	size_t operator()(int) const { return 7; }
+};
+
+struct MyFlatHashMapTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyFlatHashMap<int, string>> map;
+
+	void SetUp() override
+	{
+		map = std::make_unique<MyFlatHashMap<int, string>>();
+	}
+
+	void TearDown() override
+	{
+		map.reset();
+	}
+};
+
+TEST_F(MyFlatHashMapTest, WhenInserting_ShouldFind)
+{
+	ASSERT_EQ(map->find(1), nullptr);
+
+	auto [slot, inserted] = map->insert({ 1, "one" });
+	ASSERT_TRUE(inserted);
+	ASSERT_EQ(slot->second, "one");
+	ASSERT_EQ(map->find(1)->second, "one");
+	ASSERT_FALSE(map->contains(2));
+	ASSERT_EQ(map->size(), 1);
+}
+
+TEST_F(MyFlatHashMapTest, GivenExistingKey_WhenInserting_ShouldKeepOriginal)
+{
+	map->insert({ 1, "one" });
+	auto [slot, inserted] = map->insert({ 1, "uno" });
+	ASSERT_FALSE(inserted);
+	ASSERT_EQ(slot->second, "one");
+	ASSERT_EQ(map->size(), 1);
+}
+
+TEST_F(MyFlatHashMapTest, WhenErasing_ShouldNotFind)
+{
+	map->insert({ 1, "one" });
+	map->insert({ 2, "two" });
+
+	ASSERT_TRUE(map->erase(1));
+	ASSERT_FALSE(map->erase(1));
+	ASSERT_FALSE(map->contains(1));
+	ASSERT_EQ(map->find(2)->second, "two");
+	ASSERT_EQ(map->size(), 1);
+}
+
+TEST_F(MyFlatHashMapTest, WhenGrowingPastManyGroups_ShouldFindEveryKey)
+{
+	for (int key = 0; key < 10000; key++)
+	{
+		map->insert({ key, std::to_string(key) });
+	}
+	ASSERT_EQ(map->size(), 10000);
+	ASSERT_GE(map->get_capacity() - map->get_capacity() / 8, 10000);
+	for (int key = 0; key < 10000; key++)
+	{
+		ASSERT_EQ(map->find(key)->second, std::to_string(key));
+	}
+	ASSERT_FALSE(map->contains(10000));
+}
+
+TEST_F(MyFlatHashMapTest, GivenChurn_WhenInsertingAndErasing_ShouldAgreeWithUnorderedMap)
+{
+	std::unordered_map<int, string> expected;
+	uint64_t state = 12345;
+	for (int step = 0; step < 200000; step++)
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		const int key = static_cast<int>((state >> 33) % 2000);
+		if ((state >> 20) % 2 == 0)
+		{
+			ASSERT_EQ(map->insert({ key, std::to_string(step) }).second, expected.emplace(key, std::to_string(step)).second);
+		}
+		else
+		{
+			ASSERT_EQ(map->erase(key), expected.erase(key) == 1);
+		}
+	}
+
+	ASSERT_EQ(map->size(), expected.size());
+	for (auto& [key, value] : expected)
+	{
+		ASSERT_EQ(map->find(key)->second, value);
+	}
+	ASSERT_LE(map->get_capacity(), 4096); //deleted markers get reclaimed instead of growing the table
+}
+
+TEST_F(MyFlatHashMapTest, GivenCollidingHashes_WhenErasingAndInserting_ShouldFindEveryKey)
+{
+	MyFlatHashMap<int, int, ConstantHash> colliding;
+	for (int key = 0; key < 100; key++)
+	{
+		colliding.insert({ key, key * 10 });
+	}
+	for (int key = 0; key < 100; key += 2)
+	{
+		ASSERT_TRUE(colliding.erase(key));
+	}
+	for (int key = 1; key < 100; key += 2)
+	{
+		ASSERT_EQ(colliding.find(key)->second, key * 10);
+	}
+	colliding.insert({ 0, 1 });
+	ASSERT_EQ(colliding.find(0)->second, 1);
+	ASSERT_EQ(colliding.size(), 51);
+}
+
+TEST_F(MyFlatHashMapTest, WhenClearing_ShouldBeEmptyAndReusable)
+{
+	for (int key = 0; key < 100; key++)
+	{
+		map->insert({ key, string(32, 'x') });
+	}
+	const size_t capacity = map->get_capacity();
+
+	map->clear();
+	ASSERT_TRUE(map->is_empty());
+	ASSERT_FALSE(map->contains(5));
+	ASSERT_EQ(map->get_capacity(), capacity);
+
+	map->insert({ 5, "five" });
+	ASSERT_EQ(map->find(5)->second, "five");
+}
+
+TEST_F(MyFlatHashMapTest, WhenReserving_ShouldNotGrowWhileFilling)
+{
+	map->reserve(1000);
+	const size_t capacity = map->get_capacity();
+	for (int key = 0; key < 1000; key++)
+	{
+		map->insert({ key, "" });
+	}
+	ASSERT_EQ(map->get_capacity(), capacity);
+}
+
+TEST_F(MyFlatHashMapTest, GivenStringKeys_WhenLookingUpByStringView_ShouldFind)
+{
+	MyFlatHashMap<string, int> strings;
+	strings.insert({ "a key longer than any small string buffer", 1 });
+	strings.insert({ "two", 2 });
+
+	const string request = "GET a key longer than any small string buffer HTTP/1.1";
+	const std::string_view key = std::string_view(request).substr(4, 41);
+	ASSERT_EQ(strings.find(key)->second, 1);
+	ASSERT_TRUE(strings.contains("two"));
+	ASSERT_FALSE(strings.contains(key.substr(1)));
+	ASSERT_TRUE(strings.erase(key));
+	ASSERT_EQ(strings.find(key), nullptr);
+	ASSERT_EQ(strings.size(), 1);
+}
+
+TEST_F(MyFlatHashMapTest, GivenOpaqueHash_WhenLookingUpByOtherType_ShouldConvertToKey)
+{
+	MyFlatHashMap<long long, int, ConstantHash> converted;
+	converted.insert({ 5, 50 });
+	ASSERT_EQ(converted.find(5)->second, 50);
+	ASSERT_TRUE(converted.erase(static_cast<short>(5)));
+	ASSERT_TRUE(converted.is_empty());
+}
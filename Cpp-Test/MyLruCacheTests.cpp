@@ -1,6 +1,7 @@
 #include "pch.h"
 
 using namespace ds;
+using namespace std::chrono_literals;
 
 constexpr size_t DEFAULT_TEST_CAPACITY = 4;
 static_assert(0 != DEFAULT_TEST_CAPACITY); //special tests for this
@@ -22,6 +23,83 @@ struct MyLruCacheTest : public Test
 	}
 };
 
+using TinyLfuCache = MyLruCache<int, string, WTinyLfuPolicy>;
+using ClockCache = MyLruCache<int, string, ClockPolicy>;
+using StatsCache = MyLruCache<int, string, LruPolicy, CacheStats>;
+using RemovalLog = std::vector<std::tuple<int, string, RemovalCause>>;
+
+struct MyWTinyLfuCacheTest : public Test
+{
+
+	std::unique_ptr<TinyLfuCache> cache_;
+
+	void SetUp() override
+	{
+		cache_ = make_unique<TinyLfuCache>();
+		cache_->set_capacity(DEFAULT_TEST_CAPACITY);
+	}
+
+	void TearDown() override
+	{
+		cache_.reset();
+	}
+};
+
+struct MyClockCacheTest : public Test
+{
+
+	std::unique_ptr<ClockCache> cache_;
+
+	void SetUp() override
+	{
+		cache_ = make_unique<ClockCache>();
+		cache_->set_capacity(DEFAULT_TEST_CAPACITY);
+	}
+
+	void TearDown() override
+	{
+		cache_.reset();
+	}
+};
+
+struct MyTtlCacheTest : public Test
+{
+
+	std::unique_ptr<MyLruCache<int, string>> lru_cache_;
+	uint64_t now_ = 1000; //fake clock in milliseconds so expiry doesn't depend on timing
+
+	void SetUp() override
+	{
+		lru_cache_ = make_unique<MyLruCache<int, string>>();
+		lru_cache_->set_capacity(DEFAULT_TEST_CAPACITY);
+		lru_cache_->set_time_source([this]() { return now_; });
+	}
+
+	void TearDown() override
+	{
+		lru_cache_.reset();
+	}
+};
+
+struct MyStatsCacheTest : public Test
+{
+
+	std::unique_ptr<StatsCache> cache_;
+	uint64_t now_ = 1000;
+
+	void SetUp() override
+	{
+		cache_ = make_unique<StatsCache>();
+		cache_->set_capacity(DEFAULT_TEST_CAPACITY);
+		cache_->set_time_source([this]() { return now_; });
+	}
+
+	void TearDown() override
+	{
+		cache_.reset();
+	}
+};
+
 void GivenEmpty_WhenPutting_ShouldBeInLru(MyLruCache<int, string>& lru)
 {
 	string five = "five";
@@ -323,97 +401,1226 @@ void GivenKeyAlreadyInLru_WhenPutting_Replace(MyLruCache<int, string>& lru)
 	ASSERT_EQ(lru.get(2), TWO);
 }
 
-TEST_F(MyLruCacheTest, GivenEmpty_WhenPutting_ShouldBeInLru)
+void GivenMiddleItemRemoved_WhenOverfilling_ShouldEvictInRecencyOrder(MyLruCache<int, string>& lru)
 {
-	GivenEmpty_WhenPutting_ShouldBeInLru(*lru_cache_);
+	lru.set_capacity(3);
+	string one = "one";
+	string two = "two";
+	string three = "three";
+	lru.put(1, one);
+	lru.put(2, two);
+	lru.put(3, three);
+
+	lru.remove(2);
+
+	string four = "four";
+	string five = "five";
+	lru.put(4, four);
+	ASSERT_TRUE(lru.contains(1));
+	lru.put(5, five);
+	ASSERT_FALSE(lru.contains(1));
+	ASSERT_TRUE(lru.contains(3));
+	ASSERT_TRUE(lru.contains(4));
+	ASSERT_TRUE(lru.contains(5));
 }
 
-TEST_F(MyLruCacheTest, GivenLessItemsThanCapacity_WhenPutting_ShouldIncreaseSize)
+void GivenKeyAlreadyInLru_WhenPutting_ShouldBeMostRecentlyUsed(MyLruCache<int, string>& lru)
 {
-	GivenLessItemsThanCapacity_WhenPutting_ShouldIncreaseSize(*lru_cache_);
+	lru.set_capacity(3);
+	string one = "one";
+	string two = "two";
+	string three = "three";
+	lru.put(1, one);
+	lru.put(2, two);
+	lru.put(3, three);
+
+	string ONE = "ONE";
+	lru.put(1, ONE);
+
+	lru.set_capacity(1);
+	ASSERT_TRUE(lru.contains(1));
+	ASSERT_EQ(lru.get(1), ONE);
 }
 
-TEST_F(MyLruCacheTest, GivenFull_WhenPutting_ShouldRemoveLeastRecentlyUsed)
+void GivenEmpty_WhenPutting_ShouldBeInCache(TinyLfuCache& cache)
 {
-	GivenFull_WhenPutting_ShouldRemoveLeastRecentlyUsed(*lru_cache_);
+	string five = "five";
+	cache.put(5, five);
+	ASSERT_TRUE(cache.contains(5));
+	ASSERT_EQ(cache.get(5), five);
 }
 
-TEST_F(MyLruCacheTest,WhenRemoving_ShouldDecreaseSize)
+void WhenOverfilling_ShouldNeverExceedCapacity(TinyLfuCache& cache)
 {
-	WhenRemoving_ShouldDecreaseSize(*lru_cache_);
+	cache.set_capacity(50);
+	string value = "value";
+	for (int key = 0; key < 1000; key++)
+	{
+		cache.put(key, value);
+		ASSERT_LE(cache.size(), 50);
+	}
+	ASSERT_TRUE(cache.is_full());
 }
 
-TEST_F(MyLruCacheTest, GivenItemInLru_WhenRemoving_ShouldNotBeInLru)
+void GivenHotSet_WhenScanning_ShouldKeepHotSet(TinyLfuCache& cache)
 {
-	GivenItemInLru_WhenRemoving_ShouldNotBeInLru(*lru_cache_);
+	cache.set_capacity(100);
+	string value = "value";
+	for (int repeat = 0; repeat < 5; repeat++)
+	{
+		for (int key = 0; key < 50; key++)
+		{
+			if (cache.try_get(key) == nullptr)
+			{
+				cache.put(key, value);
+			}
+		}
+	}
+
+	//a scan of twenty times the capacity, a plain lru would lose the whole hot set after every chunk
+	int hot_misses = 0;
+	for (int chunk = 0; chunk < 20; chunk++)
+	{
+		for (int key = 0; key < 100; key++)
+		{
+			cache.put(1000 + chunk * 100 + key, value);
+		}
+		for (int key = 0; key < 50; key++)
+		{
+			if (cache.try_get(key) == nullptr)
+			{
+				++hot_misses;
+				cache.put(key, value);
+			}
+		}
+	}
+	ASSERT_EQ(hot_misses, 0);
 }
 
-TEST_F(MyLruCacheTest, GivenItemNotInLru_WhenRemoving_ShouldThrow)
+void GivenItemInCache_WhenRemoving_ShouldNotBeInCache(TinyLfuCache& cache)
 {
-	GivenItemNotInLru_WhenRemoving_ShouldThrow(*lru_cache_);
+	cache.set_capacity(10);
+	string one = "one";
+	string two = "two";
+	cache.put(1, one);
+	cache.put(2, two);
+	cache.get(1); //move 1 out of the window
+
+	cache.remove(1);
+	ASSERT_FALSE(cache.contains(1));
+	ASSERT_TRUE(cache.contains(2));
+	ASSERT_THROW({ cache.remove(1); }, std::exception);
 }
 
-TEST_F(MyLruCacheTest, GivenEmpty_WhenRemoving_ShouldThrow)
+void GivenFull_WhenClearing_ShouldBeEmpty(TinyLfuCache& cache)
 {
-	GivenEmpty_WhenRemoving_ShouldThrow(*lru_cache_);
+	cache.set_capacity(3);
+	string value = "value";
+	for (int key = 0; key < 10; key++)
+	{
+		cache.put(key, value);
+	}
+	ASSERT_TRUE(cache.is_full());
+
+	cache.clear();
+	ASSERT_TRUE(cache.is_empty());
+
+	cache.put(1, value);
+	ASSERT_TRUE(cache.contains(1));
 }
 
-TEST_F(MyLruCacheTest, GivenItemNotInLru_WhenGetting_ShouldThrow)
+void GivenFull_WhenSetCapacityToZero_ShouldBeEmpty(TinyLfuCache& cache)
 {
-	GivenItemNotInLru_WhenGetting_ShouldThrow(*lru_cache_);
+	string value = "value";
+	for (int key = 0; key < 10; key++)
+	{
+		cache.put(key, value);
+	}
+
+	cache.set_capacity(0);
+	ASSERT_TRUE(cache.is_empty());
+
+	cache.put(1, value);
+	ASSERT_TRUE(cache.is_empty());
 }
 
-TEST_F(MyLruCacheTest, GivenItemInLru_WhenGetting_ShouldGetValue)
+void GivenEmpty_WhenPutting_ShouldBeInCache(ClockCache& cache)
 {
-	GivenItemInLru_WhenGetting_ShouldGetValue(*lru_cache_);
+	string five = "five";
+	cache.put(5, five);
+	ASSERT_TRUE(cache.contains(5));
+	ASSERT_EQ(cache.get(5), five);
 }
 
-TEST_F(MyLruCacheTest, WhenCapacityChanged_ShouldGettingCapacityChange)
+void WhenOverfilling_ShouldNeverExceedCapacity(ClockCache& cache)
 {
-	WhenCapacityChanged_ShouldGettingCapacityChange(*lru_cache_);
+	cache.set_capacity(50);
+	string value = "value";
+	for (int key = 0; key < 1000; key++)
+	{
+		cache.put(key, value);
+		cache.try_get(key / 2); //keep some reference bits set
+		ASSERT_LE(cache.size(), 50);
+	}
+	ASSERT_TRUE(cache.is_full());
 }
 
-TEST_F(MyLruCacheTest, GivenFull_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity)
+void GivenReferencedItem_WhenOverfilling_ShouldGiveItASecondChance(ClockCache& cache)
 {
-	GivenFull_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity(*lru_cache_);
+	cache.set_capacity(3);
+	string one = "one";
+	string two = "two";
+	string three = "three";
+	cache.put(1, one);
+	cache.put(2, two);
+	cache.put(3, three);
+
+	cache.get(1);
+
+	string four = "four";
+	cache.put(4, four);
+	ASSERT_TRUE(cache.contains(1));
+	ASSERT_FALSE(cache.contains(2));
+	ASSERT_TRUE(cache.contains(3));
+	ASSERT_TRUE(cache.contains(4));
 }
 
-TEST_F(MyLruCacheTest, GivenFullAndGetUsed_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity)
+void GivenNoHits_WhenOverfilling_ShouldEvictInInsertionOrder(ClockCache& cache)
 {
-	GivenFullAndGetUsed_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity(*lru_cache_);
+	cache.set_capacity(3);
+	string value = "value";
+	for (int key = 1; key <= 5; key++)
+	{
+		cache.put(key, value);
+	}
+	ASSERT_FALSE(cache.contains(1));
+	ASSERT_FALSE(cache.contains(2));
+	ASSERT_TRUE(cache.contains(3));
+	ASSERT_TRUE(cache.contains(4));
+	ASSERT_TRUE(cache.contains(5));
+
+	for (int key = 6; key <= 100; key++)
+	{
+		cache.put(key, value);
+		ASSERT_FALSE(cache.contains(key - 3));
+		ASSERT_TRUE(cache.contains(key - 2));
+	}
 }
 
-TEST_F(MyLruCacheTest, GivenPreviouslyFull_WhenCapacityGrows_ShouldBeAbleToAddItemsUntilCapacity)
+void GivenSecondChance_WhenHandComesRoundAgain_ShouldEvictAfterEntriesInsertedBefore(ClockCache& cache)
 {
-	GivenPreviouslyFull_WhenCapacityGrows_ShouldBeAbleToAddItemsUntilCapacity(*lru_cache_);
+	cache.set_capacity(3);
+	string value = "value";
+	cache.put(1, value);
+	cache.put(2, value);
+	cache.put(3, value);
+	cache.get(1);
+	cache.put(4, value); //1 is passed over and lines up behind 4, 2 goes
+
+	cache.put(5, value);
+	ASSERT_FALSE(cache.contains(3));
+	cache.put(6, value);
+	ASSERT_FALSE(cache.contains(4));
+	ASSERT_TRUE(cache.contains(1));
+	cache.put(7, value);
+	ASSERT_FALSE(cache.contains(1));
+	ASSERT_TRUE(cache.contains(5));
+	ASSERT_TRUE(cache.contains(6));
+	ASSERT_TRUE(cache.contains(7));
 }
 
-TEST_F(MyLruCacheTest, GivenInLru_WhenGettingItem_ShouldBeMostRecentlyUsed)
+void GivenNoHits_WhenRestoringSnapshot_ShouldKeepNewest(ClockCache& cache)
 {
-	GivenInLru_WhenGettingItem_ShouldBeMostRecentlyUsed(*lru_cache_);
+	cache.set_capacity(3);
+	string value = "value";
+	for (int key = 1; key <= 5; key++)
+	{
+		cache.put(key, value);
+	}
+
+	std::stringstream snapshot;
+	cache.save_snapshot(snapshot);
+	ClockCache restored;
+	restored.set_capacity(2);
+	restored.load_snapshot(snapshot);
+	ASSERT_FALSE(restored.contains(3));
+	ASSERT_TRUE(restored.contains(4));
+	ASSERT_TRUE(restored.contains(5));
 }
 
-TEST_F(MyLruCacheTest, GivenFull_WhenClearing_ShouldBeEmpty)
+void GivenItemInCache_WhenRemoving_ShouldNotBeInCache(ClockCache& cache)
 {
-	GivenFull_WhenClearing_ShouldBeEmpty(*lru_cache_);
+	cache.set_capacity(3);
+	string one = "one";
+	string two = "two";
+	string three = "three";
+	cache.put(1, one);
+	cache.put(2, two);
+	cache.put(3, three);
+
+	cache.remove(1);
+	ASSERT_FALSE(cache.contains(1));
+	ASSERT_EQ(cache.size(), 2);
+
+	string four = "four";
+	string five = "five";
+	cache.put(4, four);
+	cache.put(5, five);
+	ASSERT_EQ(cache.size(), 3);
+	ASSERT_TRUE(cache.contains(5));
 }
 
-TEST_F(MyLruCacheTest, GivenEmpty_WhenClearing_ShouldBeEmpty)
+void GivenFull_WhenClearing_ShouldBeEmpty(ClockCache& cache)
 {
-	GivenEmpty_WhenClearing_ShouldBeEmpty(*lru_cache_);
+	cache.set_capacity(3);
+	string value = "value";
+	for (int key = 0; key < 10; key++)
+	{
+		cache.put(key, value);
+	}
+	ASSERT_TRUE(cache.is_full());
+
+	cache.clear();
+	ASSERT_TRUE(cache.is_empty());
+
+	cache.put(1, value);
+	ASSERT_TRUE(cache.contains(1));
 }
 
-TEST_F(MyLruCacheTest, GivenNeitherFullOrEmpty_WhenClearing_ShouldBeEmpty)
+void GivenTimeToLive_WhenTimeIsUp_ShouldNotBeInLru(MyLruCache<int, string>& lru, uint64_t& now)
 {
-	GivenNeitherFullOrEmpty_WhenClearing_ShouldBeEmpty(*lru_cache_);
+	string one = "one";
+	lru.put(1, one, 100ms);
+
+	now += 99;
+	ASSERT_TRUE(lru.contains(1));
+	ASSERT_EQ(lru.get(1), "one");
+
+	now += 1;
+	ASSERT_FALSE(lru.contains(1)); //hidden before anything reclaims it
+	ASSERT_EQ(lru.peek(1), nullptr);
+	ASSERT_THROW(lru.get(1), std::exception);
 }
 
-TEST_F(MyLruCacheTest, GivenEmpty_WhenSetCapacityToZero_ShouldBeFullAndEmpty) //this might happen to turn off caching
+void GivenExpiredEntries_WhenRemovingExpired_ShouldReclaimThem(MyLruCache<int, string>& lru, uint64_t& now)
 {
-	GivenEmpty_WhenSetCapacityToZero_ShouldBeFullAndEmpty(*lru_cache_);
+	string value = "value";
+	lru.put(1, value, 10ms);
+	lru.put(2, value, 5000ms);
+	lru.put(3, value);
+	ASSERT_EQ(lru.size(), 3);
+
+	now += 10;
+	ASSERT_EQ(lru.remove_expired(), 1);
+	ASSERT_EQ(lru.size(), 2);
+
+	now += 5000;
+	ASSERT_EQ(lru.remove_expired(), 1);
+	ASSERT_EQ(lru.size(), 1);
+	ASSERT_TRUE(lru.contains(3));
 }
 
-TEST_F(MyLruCacheTest, GivenKeyAlreadyInLru_WhenPutting_Replace) 
+void GivenExpiredEntry_WhenPutting_ShouldNotEvictLiveEntry(MyLruCache<int, string>& lru, uint64_t& now)
 {
-	GivenKeyAlreadyInLru_WhenPutting_Replace(*lru_cache_);
-}
\ No newline at end of file
+	string value = "value";
+	lru.put(1, value);
+	lru.put(2, value, 10ms);
+	lru.put(3, value);
+	lru.put(4, value);
+
+	now += 10;
+	lru.put(5, value); //the expired entry makes room rather than the least recently used one
+	ASSERT_TRUE(lru.contains(1));
+	ASSERT_FALSE(lru.contains(2));
+	ASSERT_EQ(lru.size(), 4);
+}
+
+void GivenRefreshOnGet_WhenGetting_ShouldExtendTimeToLive(MyLruCache<int, string>& lru, uint64_t& now)
+{
+	lru.set_refresh_on_get(true);
+	string one = "one";
+	lru.put(1, one, 100ms);
+
+	for (int repeat = 0; repeat < 10; repeat++)
+	{
+		now += 60;
+		ASSERT_NE(lru.try_get(1), nullptr);
+	}
+
+	now += 100;
+	ASSERT_FALSE(lru.contains(1));
+}
+
+void GivenTimeToLive_WhenPuttingWithout_ShouldNeverExpire(MyLruCache<int, string>& lru, uint64_t& now)
+{
+	string one = "one";
+	lru.put(1, one, 100ms);
+	lru.put(1, one);
+
+	now += 1000000;
+	ASSERT_TRUE(lru.contains(1));
+	ASSERT_EQ(lru.remove_expired(), 0);
+}
+
+void GivenTimeToLive_WhenEvicted_ShouldNotExpireLater(MyLruCache<int, string>& lru, uint64_t& now)
+{
+	string value = "value";
+	lru.put(1, value, 100ms);
+	for (int key = 2; key <= 5; key++)
+	{
+		lru.put(key, value);
+	}
+	ASSERT_FALSE(lru.contains(1));
+
+	now += 100;
+	ASSERT_EQ(lru.remove_expired(), 0);
+	ASSERT_EQ(lru.size(), 4);
+}
+
+size_t weigh_by_length(const int&, const string& value)
+{
+	return value.size();
+}
+
+void GivenTimeToLive_WhenRestoringSnapshot_ShouldKeepTimeLeft(MyLruCache<int, string>& lru, uint64_t& now)
+{
+	string value = "value";
+	lru.put(1, value, 100ms);
+	lru.put(2, value);
+	lru.put(3, value, 10ms);
+	now += 40; //3 has expired and isn't saved
+
+	std::stringstream snapshot;
+	lru.save_snapshot(snapshot);
+	MyLruCache<int, string> restored;
+	restored.set_capacity(DEFAULT_TEST_CAPACITY);
+	restored.set_time_source([&now]() { return now; });
+	ASSERT_EQ(restored.load_snapshot(snapshot), 2);
+
+	now += 59;
+	ASSERT_TRUE(restored.contains(1));
+	now += 1;
+	ASSERT_FALSE(restored.contains(1));
+	ASSERT_TRUE(restored.contains(2));
+}
+
+void GivenTimeToLive_WhenTimeIsUp_ShouldReportExpiredRemoval(MyLruCache<int, string>& lru, uint64_t& now)
+{
+	RemovalLog removals;
+	lru.set_removal_listener([&removals](int&& key, string&& value, RemovalCause cause) { removals.emplace_back(key, std::move(value), cause); });
+	string value = "value";
+	lru.put(1, value, 10ms);
+	now += 10;
+
+	ASSERT_EQ(lru.try_get(1), nullptr);
+	ASSERT_EQ(removals, (RemovalLog{ { 1, "value", RemovalCause::Expired } }));
+}
+
+void GivenWeigher_WhenOverBudget_ShouldEvictUntilUnderBudget(MyLruCache<int, string>& lru)
+{
+	lru.set_weigher(weigh_by_length);
+	lru.set_capacity(10);
+	string four = "aaaa";
+	string two = "bb";
+	string three = "ccc";
+	lru.put(1, four);
+	lru.put(2, four);
+	lru.put(3, two);
+	ASSERT_EQ(lru.get_weight(), 10);
+	ASSERT_TRUE(lru.is_full());
+
+	lru.put(4, three);
+	ASSERT_FALSE(lru.contains(1));
+	ASSERT_EQ(lru.get_weight(), 9);
+	ASSERT_EQ(lru.size(), 3);
+
+	lru.set_capacity(5);
+	ASSERT_EQ(lru.get_weight(), 5);
+	ASSERT_TRUE(lru.contains(3));
+	ASSERT_TRUE(lru.contains(4));
+}
+
+void GivenWeigher_WhenPuttingHeavierThanCapacity_ShouldThrowAndDropOldValue(MyLruCache<int, string>& lru)
+{
+	lru.set_weigher(weigh_by_length);
+	lru.set_capacity(10);
+	string small = "small";
+	string big = "far too big for it";
+	lru.put(1, small);
+	lru.put(2, small);
+
+	ASSERT_THROW(lru.put(1, big), std::exception);
+	ASSERT_FALSE(lru.contains(1));
+	ASSERT_TRUE(lru.contains(2)); //nothing else was evicted to make room
+	ASSERT_EQ(lru.get_weight(), 5);
+}
+
+void GivenWeigher_WhenReplacingValue_ShouldReweigh(MyLruCache<int, string>& lru)
+{
+	lru.set_weigher(weigh_by_length);
+	lru.set_capacity(10);
+	string one = "a";
+	string six = "bbbbbb";
+	lru.put(1, one);
+	lru.put(2, one);
+	lru.put(3, one);
+
+	lru.put(1, six);
+	ASSERT_EQ(lru.get_weight(), 8);
+
+	lru.put(2, six); //2 is now most recent, 3 then 1 have to go
+	ASSERT_EQ(lru.get_weight(), 6);
+	ASSERT_TRUE(lru.contains(2));
+}
+
+void GivenNonEmpty_WhenSettingWeigher_ShouldThrow(MyLruCache<int, string>& lru)
+{
+	string one = "one";
+	lru.put(1, one);
+	ASSERT_THROW(lru.set_weigher(weigh_by_length), std::exception);
+}
+
+void GivenWeigher_WhenOverfilling_ShouldStayUnderBudget(TinyLfuCache& cache)
+{
+	cache.set_weigher([](const int& key, const string&) { return static_cast<size_t>(key % 7 + 1); });
+	cache.set_capacity(200);
+	string value = "value";
+	for (int key = 0; key < 2000; key++)
+	{
+		cache.put(key % 300, value);
+		cache.try_get(key % 11);
+		ASSERT_LE(cache.get_weight(), 200);
+	}
+	ASSERT_GT(cache.size(), 0);
+}
+
+void GivenItemNotInLru_WhenGettingOrLoading_ShouldLoadAndCache(MyLruCache<int, string>& lru)
+{
+	int loads = 0;
+	auto loader = [&loads](const int& key) { ++loads; return std::to_string(key); };
+
+	ASSERT_EQ(lru.get_or_load(5, loader), "5");
+	ASSERT_EQ(lru.get_or_load(5, loader), "5");
+	ASSERT_EQ(loads, 1);
+	ASSERT_TRUE(lru.contains(5));
+}
+
+void GivenLoaderThrows_WhenGettingOrLoading_ShouldNotCache(MyLruCache<int, string>& lru)
+{
+	auto failing = [](const int&) -> string { throw std::exception("backend down"); };
+	ASSERT_THROW(lru.get_or_load(5, failing), std::exception);
+	ASSERT_FALSE(lru.contains(5));
+	ASSERT_TRUE(lru.is_empty());
+}
+
+void GivenNoDefaultConstructor_WhenGettingOrLoading_ShouldLoadAndCache(MyLruCache<int, string>&)
+{
+	struct Reading
+	{
+		explicit Reading(int celsius) : celsius(celsius) {}
+		int celsius;
+	};
+	MyLruCache<int, Reading> cache;
+	ASSERT_EQ(cache.get_or_load(1, [](const int& key) { return Reading(key * 10); }).celsius, 10);
+	ASSERT_EQ(cache.get(1).celsius, 10);
+}
+
+void WhenGettingAndPutting_ShouldCountHitsMissesAndPuts(StatsCache& cache, uint64_t&)
+{
+	string value = "value";
+	cache.put(1, value);
+	cache.put(1, value);
+	cache.try_get(1);
+	cache.try_get(2);
+	ASSERT_FALSE(cache.contains(3)); //contains and peek aren't lookups for the hit ratio
+	cache.touch(1);
+
+	CacheStatsSnapshot stats = cache.get_stats();
+	ASSERT_EQ(stats.puts, 2);
+	ASSERT_EQ(stats.hits, 1);
+	ASSERT_EQ(stats.misses, 1);
+	ASSERT_DOUBLE_EQ(stats.hit_ratio(), 0.5);
+	ASSERT_EQ(stats.weight, 1);
+}
+
+void WhenEntriesLeave_ShouldCountEachCause(StatsCache& cache, uint64_t& now)
+{
+	string value = "value";
+	for (int key = 0; key < 6; key++)
+	{
+		cache.put(key, value);
+	}
+	cache.remove(5);
+	cache.put(10, value, 10ms);
+	now += 10;
+	ASSERT_EQ(cache.try_get(10), nullptr);
+
+	CacheStatsSnapshot stats = cache.get_stats();
+	ASSERT_EQ(stats.capacity_evictions, 2);
+	ASSERT_EQ(stats.removals, 1);
+	ASSERT_EQ(stats.expired_evictions, 1);
+	ASSERT_EQ(stats.weight, cache.get_weight());
+}
+
+void WhenLoading_ShouldCountSuccessesAndFailures(StatsCache& cache, uint64_t&)
+{
+	cache.get_or_load(1, [](const int&) { return string("one"); });
+	cache.get_or_load(1, [](const int&) { return string("one"); });
+	ASSERT_THROW(cache.get_or_load(2, [](const int&) -> string { throw std::exception("backend down"); }), std::exception);
+
+	CacheStatsSnapshot stats = cache.get_stats();
+	ASSERT_EQ(stats.load_successes, 1);
+	ASSERT_EQ(stats.load_failures, 1);
+	ASSERT_EQ(stats.hits, 1);
+	ASSERT_EQ(stats.misses, 2);
+}
+
+void GivenNoStats_WhenUsed_ShouldReportZeros(MyLruCache<int, string>& lru)
+{
+	string value = "value";
+	lru.put(1, value);
+	lru.try_get(1);
+	ASSERT_EQ(lru.get_stats().hits, 0);
+	ASSERT_EQ(lru.get_stats().puts, 0);
+}
+
+void WhenPuttingMany_ShouldBeSameAsPuttingEach(MyLruCache<int, string>& lru)
+{
+	std::vector<int> keys = { 1, 2, 3, 4, 5, 2 };
+	std::vector<string> values = { "one", "two", "three", "four", "five", "TWO" };
+	lru.put_many(keys, values);
+
+	ASSERT_EQ(lru.size(), 4);
+	ASSERT_FALSE(lru.contains(1));
+	ASSERT_EQ(lru.get(2), "TWO");
+	ASSERT_EQ(lru.get(5), "five");
+}
+
+void WhenGettingMany_ShouldReturnHitsAndMissesInKeyOrder(MyLruCache<int, string>& lru)
+{
+	string one = "one";
+	string three = "three";
+	lru.put(1, one);
+	lru.put(3, three);
+
+	std::vector<string*> values;
+	ASSERT_EQ(lru.get_many({ 3, 2, 1 }, values), 2);
+	ASSERT_EQ(values.size(), 3);
+	ASSERT_EQ(*values[0], "three");
+	ASSERT_EQ(values[1], nullptr);
+	ASSERT_EQ(*values[2], "one");
+}
+
+void GivenMismatchedLengths_WhenPuttingMany_ShouldThrow(MyLruCache<int, string>& lru)
+{
+	std::vector<string> values = { "one" };
+	ASSERT_THROW(lru.put_many({ 1, 2 }, values), std::exception);
+}
+
+//counts how often values get copied so the move paths can be checked
+struct CopyCounted
+{
+	static int copies;
+	string text;
+
+	CopyCounted() = default;
+	CopyCounted(string text, int repeat) : text()
+	{
+		for (int index = 0; index < repeat; index++)
+		{
+			this->text += text;
+		}
+	}
+	CopyCounted(const CopyCounted& other) : text(other.text) { ++copies; }
+	CopyCounted(CopyCounted&&) noexcept = default;
+	CopyCounted& operator=(const CopyCounted& other) { text = other.text; ++copies; return *this; }
+	CopyCounted& operator=(CopyCounted&&) noexcept = default;
+};
+
+int CopyCounted::copies = 0;
+
+void WhenPuttingRvalue_ShouldNotCopyValue(MyLruCache<int, string>&)
+{
+	MyLruCache<string, CopyCounted> cache;
+	CopyCounted::copies = 0;
+
+	cache.put(string("key"), CopyCounted("ab", 2));
+	string key = "key";
+	cache.put(key, CopyCounted("cd", 1)); //replaces by move too
+	ASSERT_EQ(CopyCounted::copies, 0);
+	ASSERT_EQ(cache.get(key).text, "cd");
+	ASSERT_EQ(cache.size(), 1);
+}
+
+void WhenEmplacing_ShouldBuildValueInPlace(MyLruCache<int, string>&)
+{
+	MyLruCache<string, CopyCounted> cache;
+	CopyCounted::copies = 0;
+
+	cache.emplace("key", "ab", 3);
+	ASSERT_EQ(cache.get("key").text, "ababab");
+	cache.emplace("key", "x", 1);
+	ASSERT_EQ(cache.get("key").text, "x");
+	ASSERT_EQ(CopyCounted::copies, 0);
+}
+
+void GivenWeigher_WhenEmplacing_ShouldWeighBuiltValue(MyLruCache<int, string>& lru)
+{
+	lru.set_weigher(weigh_by_length);
+	lru.set_capacity(10);
+	lru.emplace(1, 4, 'a');
+	lru.emplace(2, 6, 'b');
+	ASSERT_EQ(lru.get_weight(), 10);
+	ASSERT_EQ(lru.get(1), "aaaa");
+
+	ASSERT_THROW(lru.emplace(3, 11, 'c'), std::exception);
+	ASSERT_FALSE(lru.contains(3));
+}
+
+void GivenStringKeys_WhenLookingUpByStringView_ShouldFindEntry(MyLruCache<int, string>&)
+{
+	MyLruCache<string, int> cache;
+	cache.put(string("a key longer than any small string buffer"), 1);
+	cache.put(string("another key"), 2);
+
+	const string request = "GET a key longer than any small string buffer HTTP/1.1";
+	const std::string_view key = std::string_view(request).substr(4, 41);
+	ASSERT_EQ(*cache.try_get(key), 1);
+	ASSERT_EQ(cache.get(key), 1);
+	ASSERT_EQ(*cache.peek(key), 1);
+	ASSERT_TRUE(cache.touch(key));
+	ASSERT_TRUE(cache.contains("another key"));
+	ASSERT_EQ(cache.try_get(key.substr(1)), nullptr);
+
+	cache.remove(key);
+	ASSERT_FALSE(cache.contains(key));
+	ASSERT_THROW(cache.remove(key), std::exception);
+	ASSERT_EQ(cache.size(), 1);
+}
+
+void GivenMissesByStringView_WhenPutting_ShouldCountTowardsAdmission(MyLruCache<int, string>&)
+{
+	//hot is only ever missed, and by string_view, so those misses are all that can get it admitted over the scan
+	MyLruCache<string, int, WTinyLfuPolicy> cache;
+	cache.set_capacity(100);
+	for (int key = 0; key < 100; key++)
+	{
+		cache.put("cold " + std::to_string(key), key);
+	}
+	const string hot = "hot";
+	for (int miss = 0; miss < 10; miss++)
+	{
+		ASSERT_EQ(cache.try_get(std::string_view(hot)), nullptr);
+	}
+	for (int key = 0; key < 100; key++)
+	{
+		cache.put("scan " + std::to_string(key), key);
+	}
+	cache.put(hot, 1);
+	for (int key = 100; key < 200; key++)
+	{
+		cache.put("scan " + std::to_string(key), key);
+	}
+	ASSERT_TRUE(cache.contains(hot));
+}
+
+void GivenRemovalListener_WhenEntriesLeave_ShouldReportKeyValueAndCause(MyLruCache<int, string>& lru)
+{
+	RemovalLog removals;
+	lru.set_removal_listener([&removals](int&& key, string&& value, RemovalCause cause) { removals.emplace_back(key, std::move(value), cause); });
+	lru.set_capacity(2);
+	lru.put(1, string("one"));
+	lru.put(2, string("two"));
+	lru.put(3, string("three"));
+	lru.put(2, string("deux"));
+	lru.remove(3);
+	lru.clear();
+
+	ASSERT_EQ(removals, (RemovalLog{
+		{ 1, "one", RemovalCause::Capacity },
+		{ 2, "two", RemovalCause::Replaced },
+		{ 3, "three", RemovalCause::Explicit },
+		{ 2, "deux", RemovalCause::Explicit } }));
+}
+
+void GivenMoveOnlyValues_WhenEvicting_ShouldHandValueToListener(MyLruCache<int, string>&)
+{
+	MyLruCache<int, std::unique_ptr<int>> cache;
+	cache.set_capacity(1);
+	std::unique_ptr<int> evicted;
+	cache.set_removal_listener([&evicted](int&&, std::unique_ptr<int>&& value, RemovalCause) { evicted = std::move(value); });
+	cache.put(1, std::make_unique<int>(10));
+	const int* address = cache.get(1).get();
+
+	cache.put(2, std::make_unique<int>(20));
+	ASSERT_EQ(evicted.get(), address);
+	ASSERT_EQ(*evicted, 10);
+}
+
+void GivenListenerUsingCache_WhenEvicting_ShouldSeeFinishedChange(MyLruCache<int, string>& lru)
+{
+	lru.set_capacity(2);
+	lru.set_removal_listener([&lru](int&& key, string&& value, RemovalCause)
+	{
+		ASSERT_FALSE(lru.contains(key));
+		ASSERT_LE(lru.size(), 2);
+		if (key == 1)
+		{
+			lru.put(100, std::move(value)); //evicts 2, which is delivered by this put
+		}
+	});
+	lru.put(1, string("one"));
+	lru.put(2, string("two"));
+	lru.put(3, string("three"));
+
+	ASSERT_EQ(lru.get(100), "one");
+	ASSERT_TRUE(lru.contains(3));
+	ASSERT_FALSE(lru.contains(2));
+}
+
+void GivenUsedEntries_WhenRestoringSnapshot_ShouldKeepRecencyOrder(MyLruCache<int, string>& lru)
+{
+	string values[] = { "one", "two", "three", "four" };
+	for (int key = 1; key <= 4; key++)
+	{
+		lru.put(key, values[key - 1]);
+	}
+	lru.get(1);
+	lru.get(3); //least to most recent is now 2, 4, 1, 3
+
+	std::stringstream snapshot;
+	lru.save_snapshot(snapshot);
+	MyLruCache<int, string> restored;
+	restored.set_capacity(DEFAULT_TEST_CAPACITY);
+	ASSERT_EQ(restored.load_snapshot(snapshot), 4);
+	ASSERT_EQ(restored.get(1), "one");
+	ASSERT_EQ(restored.get(3), "three");
+
+	string five = "five";
+	restored.put(5, five);
+	ASSERT_FALSE(restored.contains(2));
+	restored.put(6, five);
+	ASSERT_FALSE(restored.contains(4));
+	ASSERT_TRUE(restored.contains(1));
+}
+
+void GivenSmallerCapacity_WhenRestoringSnapshot_ShouldKeepMostRecent(MyLruCache<int, string>& lru)
+{
+	string value = "value";
+	for (int key = 1; key <= 4; key++)
+	{
+		lru.put(key, value);
+	}
+	lru.get(2);
+
+	std::stringstream snapshot;
+	lru.save_snapshot(snapshot);
+	MyLruCache<int, string> restored;
+	restored.set_capacity(2);
+	restored.load_snapshot(snapshot);
+	ASSERT_EQ(restored.size(), 2);
+	ASSERT_TRUE(restored.contains(4));
+	ASSERT_TRUE(restored.contains(2));
+}
+
+void GivenGarbage_WhenRestoringSnapshot_ShouldThrow(MyLruCache<int, string>& lru)
+{
+	std::stringstream garbage("not a snapshot");
+	ASSERT_THROW(lru.load_snapshot(garbage), std::exception);
+
+	string value = "value";
+	lru.put(1, value);
+	std::stringstream snapshot;
+	lru.save_snapshot(snapshot);
+	std::stringstream truncated(snapshot.str().substr(0, snapshot.str().size() - 3));
+	MyLruCache<int, string> restored;
+	ASSERT_THROW(restored.load_snapshot(truncated), std::exception);
+
+	std::stringstream corrupt;
+	write_snapshot_header(corrupt, 1);
+	SnapshotSerializer<int>::write(corrupt, 1);
+	write_snapshot_u64(corrupt, uint64_t(1) << 40); //a string length far past the bytes behind it
+	corrupt << value;
+	try
+	{
+		restored.load_snapshot(corrupt);
+		FAIL();
+	}
+	catch (const std::exception& exception)
+	{
+		ASSERT_STREQ(exception.what(), "snapshot truncated");
+	}
+}
+
+//snapshots only the text, the repeat count isn't worth keeping
+struct CopyCountedSerializer
+{
+	static void write(std::ostream& out, const CopyCounted& value) { SnapshotSerializer<string>::write(out, value.text); }
+	static CopyCounted read(std::istream& in) { return CopyCounted(SnapshotSerializer<string>::read(in), 1); }
+};
+
+void GivenCustomSerializer_WhenRestoringSnapshot_ShouldUseIt(MyLruCache<int, string>&)
+{
+	MyLruCache<string, CopyCounted> cache;
+	cache.emplace("a", "xy", 2);
+	cache.emplace("b", "z", 1);
+
+	std::stringstream snapshot;
+	cache.save_snapshot<SnapshotSerializer<string>, CopyCountedSerializer>(snapshot);
+	MyLruCache<string, CopyCounted> restored;
+	CopyCounted::copies = 0;
+	restored.load_snapshot<SnapshotSerializer<string>, CopyCountedSerializer>(snapshot);
+	ASSERT_EQ(CopyCounted::copies, 0);
+	ASSERT_EQ(restored.get("a").text, "xyxy");
+	ASSERT_EQ(restored.get("b").text, "z");
+}
+
+TEST_F(MyLruCacheTest, GivenEmpty_WhenPutting_ShouldBeInLru)
+{
+	GivenEmpty_WhenPutting_ShouldBeInLru(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenLessItemsThanCapacity_WhenPutting_ShouldIncreaseSize)
+{
+	GivenLessItemsThanCapacity_WhenPutting_ShouldIncreaseSize(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenFull_WhenPutting_ShouldRemoveLeastRecentlyUsed)
+{
+	GivenFull_WhenPutting_ShouldRemoveLeastRecentlyUsed(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest,WhenRemoving_ShouldDecreaseSize)
+{
+	WhenRemoving_ShouldDecreaseSize(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenItemInLru_WhenRemoving_ShouldNotBeInLru)
+{
+	GivenItemInLru_WhenRemoving_ShouldNotBeInLru(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenItemNotInLru_WhenRemoving_ShouldThrow)
+{
+	GivenItemNotInLru_WhenRemoving_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenEmpty_WhenRemoving_ShouldThrow)
+{
+	GivenEmpty_WhenRemoving_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenItemNotInLru_WhenGetting_ShouldThrow)
+{
+	GivenItemNotInLru_WhenGetting_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenItemInLru_WhenGetting_ShouldGetValue)
+{
+	GivenItemInLru_WhenGetting_ShouldGetValue(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, WhenCapacityChanged_ShouldGettingCapacityChange)
+{
+	WhenCapacityChanged_ShouldGettingCapacityChange(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenFull_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity)
+{
+	GivenFull_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenFullAndGetUsed_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity)
+{
+	GivenFullAndGetUsed_WhenCapacityShrunk_ShouldRemoveLeastRecentlyUsedElementsUntilNewCapacity(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenPreviouslyFull_WhenCapacityGrows_ShouldBeAbleToAddItemsUntilCapacity)
+{
+	GivenPreviouslyFull_WhenCapacityGrows_ShouldBeAbleToAddItemsUntilCapacity(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenInLru_WhenGettingItem_ShouldBeMostRecentlyUsed)
+{
+	GivenInLru_WhenGettingItem_ShouldBeMostRecentlyUsed(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenFull_WhenClearing_ShouldBeEmpty)
+{
+	GivenFull_WhenClearing_ShouldBeEmpty(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenEmpty_WhenClearing_ShouldBeEmpty)
+{
+	GivenEmpty_WhenClearing_ShouldBeEmpty(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenNeitherFullOrEmpty_WhenClearing_ShouldBeEmpty)
+{
+	GivenNeitherFullOrEmpty_WhenClearing_ShouldBeEmpty(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenEmpty_WhenSetCapacityToZero_ShouldBeFullAndEmpty) //this might happen to turn off caching
+{
+	GivenEmpty_WhenSetCapacityToZero_ShouldBeFullAndEmpty(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenKeyAlreadyInLru_WhenPutting_Replace) 
+{
+	GivenKeyAlreadyInLru_WhenPutting_Replace(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenMiddleItemRemoved_WhenOverfilling_ShouldEvictInRecencyOrder)
+{
+	GivenMiddleItemRemoved_WhenOverfilling_ShouldEvictInRecencyOrder(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenKeyAlreadyInLru_WhenPutting_ShouldBeMostRecentlyUsed)
+{
+	GivenKeyAlreadyInLru_WhenPutting_ShouldBeMostRecentlyUsed(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenWeigher_WhenOverBudget_ShouldEvictUntilUnderBudget)
+{
+	GivenWeigher_WhenOverBudget_ShouldEvictUntilUnderBudget(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenWeigher_WhenPuttingHeavierThanCapacity_ShouldThrowAndDropOldValue)
+{
+	GivenWeigher_WhenPuttingHeavierThanCapacity_ShouldThrowAndDropOldValue(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenWeigher_WhenReplacingValue_ShouldReweigh)
+{
+	GivenWeigher_WhenReplacingValue_ShouldReweigh(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenNonEmpty_WhenSettingWeigher_ShouldThrow)
+{
+	GivenNonEmpty_WhenSettingWeigher_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenItemNotInLru_WhenGettingOrLoading_ShouldLoadAndCache)
+{
+	GivenItemNotInLru_WhenGettingOrLoading_ShouldLoadAndCache(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenLoaderThrows_WhenGettingOrLoading_ShouldNotCache)
+{
+	GivenLoaderThrows_WhenGettingOrLoading_ShouldNotCache(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenNoDefaultConstructor_WhenGettingOrLoading_ShouldLoadAndCache)
+{
+	GivenNoDefaultConstructor_WhenGettingOrLoading_ShouldLoadAndCache(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenNoStats_WhenUsed_ShouldReportZeros)
+{
+	GivenNoStats_WhenUsed_ShouldReportZeros(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, WhenPuttingMany_ShouldBeSameAsPuttingEach)
+{
+	WhenPuttingMany_ShouldBeSameAsPuttingEach(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, WhenGettingMany_ShouldReturnHitsAndMissesInKeyOrder)
+{
+	WhenGettingMany_ShouldReturnHitsAndMissesInKeyOrder(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenMismatchedLengths_WhenPuttingMany_ShouldThrow)
+{
+	GivenMismatchedLengths_WhenPuttingMany_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, WhenPuttingRvalue_ShouldNotCopyValue)
+{
+	WhenPuttingRvalue_ShouldNotCopyValue(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, WhenEmplacing_ShouldBuildValueInPlace)
+{
+	WhenEmplacing_ShouldBuildValueInPlace(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenWeigher_WhenEmplacing_ShouldWeighBuiltValue)
+{
+	GivenWeigher_WhenEmplacing_ShouldWeighBuiltValue(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenStringKeys_WhenLookingUpByStringView_ShouldFindEntry)
+{
+	GivenStringKeys_WhenLookingUpByStringView_ShouldFindEntry(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenMissesByStringView_WhenPutting_ShouldCountTowardsAdmission)
+{
+	GivenMissesByStringView_WhenPutting_ShouldCountTowardsAdmission(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenRemovalListener_WhenEntriesLeave_ShouldReportKeyValueAndCause)
+{
+	GivenRemovalListener_WhenEntriesLeave_ShouldReportKeyValueAndCause(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenMoveOnlyValues_WhenEvicting_ShouldHandValueToListener)
+{
+	GivenMoveOnlyValues_WhenEvicting_ShouldHandValueToListener(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenListenerUsingCache_WhenEvicting_ShouldSeeFinishedChange)
+{
+	GivenListenerUsingCache_WhenEvicting_ShouldSeeFinishedChange(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenUsedEntries_WhenRestoringSnapshot_ShouldKeepRecencyOrder)
+{
+	GivenUsedEntries_WhenRestoringSnapshot_ShouldKeepRecencyOrder(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenSmallerCapacity_WhenRestoringSnapshot_ShouldKeepMostRecent)
+{
+	GivenSmallerCapacity_WhenRestoringSnapshot_ShouldKeepMostRecent(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenGarbage_WhenRestoringSnapshot_ShouldThrow)
+{
+	GivenGarbage_WhenRestoringSnapshot_ShouldThrow(*lru_cache_);
+}
+
+TEST_F(MyLruCacheTest, GivenCustomSerializer_WhenRestoringSnapshot_ShouldUseIt)
+{
+	GivenCustomSerializer_WhenRestoringSnapshot_ShouldUseIt(*lru_cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, GivenEmpty_WhenPutting_ShouldBeInCache)
+{
+	GivenEmpty_WhenPutting_ShouldBeInCache(*cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, WhenOverfilling_ShouldNeverExceedCapacity)
+{
+	WhenOverfilling_ShouldNeverExceedCapacity(*cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, GivenHotSet_WhenScanning_ShouldKeepHotSet)
+{
+	GivenHotSet_WhenScanning_ShouldKeepHotSet(*cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, GivenItemInCache_WhenRemoving_ShouldNotBeInCache)
+{
+	GivenItemInCache_WhenRemoving_ShouldNotBeInCache(*cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, GivenFull_WhenClearing_ShouldBeEmpty)
+{
+	GivenFull_WhenClearing_ShouldBeEmpty(*cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, GivenFull_WhenSetCapacityToZero_ShouldBeEmpty)
+{
+	GivenFull_WhenSetCapacityToZero_ShouldBeEmpty(*cache_);
+}
+
+TEST_F(MyWTinyLfuCacheTest, GivenWeigher_WhenOverfilling_ShouldStayUnderBudget)
+{
+	GivenWeigher_WhenOverfilling_ShouldStayUnderBudget(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenEmpty_WhenPutting_ShouldBeInCache)
+{
+	GivenEmpty_WhenPutting_ShouldBeInCache(*cache_);
+}
+
+TEST_F(MyClockCacheTest, WhenOverfilling_ShouldNeverExceedCapacity)
+{
+	WhenOverfilling_ShouldNeverExceedCapacity(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenReferencedItem_WhenOverfilling_ShouldGiveItASecondChance)
+{
+	GivenReferencedItem_WhenOverfilling_ShouldGiveItASecondChance(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenNoHits_WhenOverfilling_ShouldEvictInInsertionOrder)
+{
+	GivenNoHits_WhenOverfilling_ShouldEvictInInsertionOrder(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenSecondChance_WhenHandComesRoundAgain_ShouldEvictAfterEntriesInsertedBefore)
+{
+	GivenSecondChance_WhenHandComesRoundAgain_ShouldEvictAfterEntriesInsertedBefore(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenNoHits_WhenRestoringSnapshot_ShouldKeepNewest)
+{
+	GivenNoHits_WhenRestoringSnapshot_ShouldKeepNewest(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenItemInCache_WhenRemoving_ShouldNotBeInCache)
+{
+	GivenItemInCache_WhenRemoving_ShouldNotBeInCache(*cache_);
+}
+
+TEST_F(MyClockCacheTest, GivenFull_WhenClearing_ShouldBeEmpty)
+{
+	GivenFull_WhenClearing_ShouldBeEmpty(*cache_);
+}
+
+TEST_F(MyTtlCacheTest, GivenTimeToLive_WhenTimeIsUp_ShouldNotBeInLru)
+{
+	GivenTimeToLive_WhenTimeIsUp_ShouldNotBeInLru(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenExpiredEntries_WhenRemovingExpired_ShouldReclaimThem)
+{
+	GivenExpiredEntries_WhenRemovingExpired_ShouldReclaimThem(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenExpiredEntry_WhenPutting_ShouldNotEvictLiveEntry)
+{
+	GivenExpiredEntry_WhenPutting_ShouldNotEvictLiveEntry(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenRefreshOnGet_WhenGetting_ShouldExtendTimeToLive)
+{
+	GivenRefreshOnGet_WhenGetting_ShouldExtendTimeToLive(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenTimeToLive_WhenPuttingWithout_ShouldNeverExpire)
+{
+	GivenTimeToLive_WhenPuttingWithout_ShouldNeverExpire(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenTimeToLive_WhenEvicted_ShouldNotExpireLater)
+{
+	GivenTimeToLive_WhenEvicted_ShouldNotExpireLater(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenTimeToLive_WhenRestoringSnapshot_ShouldKeepTimeLeft)
+{
+	GivenTimeToLive_WhenRestoringSnapshot_ShouldKeepTimeLeft(*lru_cache_, now_);
+}
+
+TEST_F(MyTtlCacheTest, GivenTimeToLive_WhenTimeIsUp_ShouldReportExpiredRemoval)
+{
+	GivenTimeToLive_WhenTimeIsUp_ShouldReportExpiredRemoval(*lru_cache_, now_);
+}
+
+TEST_F(MyStatsCacheTest, WhenGettingAndPutting_ShouldCountHitsMissesAndPuts)
+{
+	WhenGettingAndPutting_ShouldCountHitsMissesAndPuts(*cache_, now_);
+}
+
+TEST_F(MyStatsCacheTest, WhenEntriesLeave_ShouldCountEachCause)
+{
+	WhenEntriesLeave_ShouldCountEachCause(*cache_, now_);
+}
+
+TEST_F(MyStatsCacheTest, WhenLoading_ShouldCountSuccessesAndFailures)
+{
+	WhenLoading_ShouldCountSuccessesAndFailures(*cache_, now_);
+}
@@ -0,0 +1,235 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct MyMpmcQueueTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyMpmcQueue<int>> queue;
+
+	void SetUp() override
+	{
+		queue = std::make_unique<MyMpmcQueue<int>>(6);
+	}
+
+	void TearDown() override
+	{
+		queue.reset();
+	}
+};
+
+//producer_count threads each offer items_each values, consumer_count threads poll until every value is in,
+//returns how many times each value arrived, values are producer * items_each + sequence
+template<typename TOffer, typename TPoll>
+std::vector<int> pass_between_threads(int producer_count, int consumer_count, int items_each, TOffer offer, TPoll poll)
+{
+	const int total = producer_count * items_each;
+	std::vector<std::atomic<int>> arrivals(total);
+	std::atomic<int> received = 0;
+	std::vector<std::thread> threads;
+	for (int producer = 0; producer < producer_count; producer++)
+	{
+		threads.emplace_back([&, producer]
+		{
+			for (int sequence = 0; sequence < items_each; sequence++)
+			{
+				offer(producer * items_each + sequence);
+			}
+		});
+	}
+	for (int consumer = 0; consumer < consumer_count; consumer++)
+	{
+		threads.emplace_back([&]
+		{
+			int value = 0;
+			while (received.load() < total)
+			{
+				if (poll(value))
+				{
+					arrivals[value].fetch_add(1);
+					received.fetch_add(1);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	std::vector<int> counts;
+	for (std::atomic<int>& count : arrivals)
+	{
+		counts.push_back(count.load());
+	}
+	return counts;
+}
+
+TEST_F(MyMpmcQueueTest, WhenConstructing_ShouldRoundCapacityUpToPowerOfTwo)
+{
+	ASSERT_EQ(queue->get_capacity(), 8);
+	ASSERT_EQ(MyMpmcQueue<int>(1).get_capacity(), 2);
+	ASSERT_THROW(MyMpmcQueue<int>(0), std::exception);
+}
+
+TEST_F(MyMpmcQueueTest, GivenFull_WhenOffering_ShouldRefuse)
+{
+	for (int value = 0; value < 8; value++)
+	{
+		ASSERT_TRUE(queue->try_offer(value));
+	}
+	ASSERT_FALSE(queue->try_offer(8));
+	ASSERT_THROW(queue->offer(8), std::exception);
+	ASSERT_EQ(queue->get_count(), 8);
+}
+
+TEST_F(MyMpmcQueueTest, GivenManyLaps_WhenOfferingAndPolling_ShouldKeepOrder)
+{
+	int polled = -1;
+	ASSERT_FALSE(queue->try_poll(polled));
+	int next_out = 0;
+	for (int value = 0; value < 1000; value++)
+	{
+		ASSERT_TRUE(queue->try_offer(value));
+		if (value % 7 == 6) //runs 7 deep, so the cells are reused at every offset
+		{
+			while (queue->try_poll(polled))
+			{
+				ASSERT_EQ(polled, next_out++);
+			}
+		}
+	}
+	while (queue->try_poll(polled))
+	{
+		ASSERT_EQ(polled, next_out++);
+	}
+	ASSERT_EQ(next_out, 1000);
+}
+
+TEST_F(MyMpmcQueueTest, GivenItemsLeft_WhenDestroying_ShouldDestroyThem)
+{
+	auto shared = std::make_shared<int>(1);
+	{
+		MyMpmcQueue<std::shared_ptr<int>> owners(4);
+		owners.try_offer(shared);
+		owners.try_emplace(shared);
+		std::shared_ptr<int> polled;
+		owners.try_poll(polled);
+		ASSERT_EQ(shared.use_count(), 3);
+	}
+	ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST_F(MyMpmcQueueTest, GivenManyProducersAndConsumers_WhenPassingItems_ShouldDeliverEachOnce)
+{
+	const std::vector<int> arrivals = pass_between_threads(4, 4, 20'000,
+		[this](int value)
+		{
+			while (!queue->try_offer(value))
+			{
+				std::this_thread::yield();
+			}
+		},
+		[this](int& out_value)
+		{
+			if (queue->try_poll(out_value)) return true;
+			std::this_thread::yield();
+			return false;
+		});
+	ASSERT_EQ(std::count(arrivals.begin(), arrivals.end(), 1), static_cast<std::ptrdiff_t>(arrivals.size()));
+	ASSERT_EQ(queue->get_count(), 0);
+}
+
+TEST_F(MyMpmcQueueTest, WhenPollingTwoQueues_ShouldKeepEachReferenceUntilThatQueuePollsAgain)
+{
+	MyMpmcQueue<int> other(4);
+	queue->offer(1);
+	other.offer(2);
+	const int& first = queue->poll();
+	const int& second = other.poll();
+	ASSERT_EQ(first, 1);
+	ASSERT_EQ(second, 2);
+}
+
+TEST_F(MyMpmcQueueTest, GivenPolled_WhenDestroying_ShouldReleaseItem)
+{
+	auto shared = std::make_shared<int>(1);
+	{
+		MyMpmcQueue<std::shared_ptr<int>> owners(4);
+		owners.offer(shared);
+		owners.poll();
+		ASSERT_EQ(shared.use_count(), 2);
+	}
+	ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST(MyBlockingMpmcQueueTest, GivenEmpty_WhenTaking_ShouldWaitForOffer)
+{
+	MyBlockingMpmcQueue<int> queue(4);
+	int taken = 0;
+	std::thread consumer([&] { taken = queue.take(); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(50)); //long enough to have parked
+	queue.offer(7);
+	consumer.join();
+	ASSERT_EQ(taken, 7);
+}
+
+TEST(MyBlockingMpmcQueueTest, GivenNoDefaultConstructor_WhenTaking_ShouldMoveItemOut)
+{
+	struct Ticket
+	{
+		int number;
+		explicit Ticket(int value) : number(value) {}
+	};
+
+	MyBlockingMpmcQueue<Ticket> queue(4);
+	queue.offer(Ticket(3));
+	ASSERT_EQ(queue.take().number, 3);
+}
+
+TEST(MyBlockingMpmcQueueTest, GivenFull_WhenOffering_ShouldWaitForPoll)
+{
+	MyBlockingMpmcQueue<int> queue(2);
+	queue.offer(0);
+	queue.offer(1);
+	std::thread producer([&] { queue.offer(2); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	ASSERT_EQ(queue.poll(), 0);
+	producer.join();
+	ASSERT_EQ(queue.poll(), 1);
+	ASSERT_EQ(queue.poll(), 2);
+}
+
+TEST(MyBlockingMpmcQueueTest, GivenManyProducersAndConsumers_WhenPassingItems_ShouldDeliverEachOnce)
+{
+	MyBlockingMpmcQueue<int> queue(16);
+	constexpr int PRODUCERS = 4;
+	constexpr int ITEMS_EACH = 10'000;
+	//consumers take a fixed share each, so every blocking take is matched by an offer
+	std::vector<std::atomic<int>> arrivals(PRODUCERS * ITEMS_EACH);
+	std::vector<std::thread> threads;
+	for (int producer = 0; producer < PRODUCERS; producer++)
+	{
+		threads.emplace_back([&, producer]
+		{
+			for (int sequence = 0; sequence < ITEMS_EACH; sequence++)
+			{
+				queue.offer(producer * ITEMS_EACH + sequence);
+			}
+		});
+		threads.emplace_back([&]
+		{
+			for (int taken = 0; taken < ITEMS_EACH; taken++)
+			{
+				arrivals[queue.take()].fetch_add(1);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	for (std::atomic<int>& count : arrivals)
+	{
+		ASSERT_EQ(count.load(), 1);
+	}
+}
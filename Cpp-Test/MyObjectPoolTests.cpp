@@ -0,0 +1,54 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct MyObjectPoolTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyObjectPool<string>> pool;
+
+	void SetUp() override
+	{
+		pool = std::make_unique<MyObjectPool<string>>();
+	}
+
+	void TearDown() override
+	{
+		pool.reset();
+	}
+};
+
+TEST_F(MyObjectPoolTest, WhenMaking_ShouldBuildDistinctObjects)
+{
+	std::vector<string*> made;
+	for (int index = 0; index < 100; index++)
+	{
+		made.push_back(pool->make(3, static_cast<char>('a' + index % 26)));
+	}
+	ASSERT_EQ(pool->size(), 100);
+	ASSERT_EQ(*made[1], "bbb");
+	std::vector<string*> distinct = made;
+	std::sort(distinct.begin(), distinct.end());
+	ASSERT_EQ(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+	for (string* object : made)
+	{
+		pool->release(object);
+	}
+	ASSERT_EQ(pool->size(), 0);
+}
+
+TEST_F(MyObjectPoolTest, GivenReleased_WhenMaking_ShouldReuseSlot)
+{
+	string* first = pool->make("first");
+	string* second = pool->make("second");
+	const size_t allocated = pool->allocated_bytes();
+
+	pool->release(first);
+	string* third = pool->make("third");
+	ASSERT_EQ(third, first);
+	ASSERT_EQ(*third, "third");
+	ASSERT_EQ(pool->allocated_bytes(), allocated);
+	pool->release(third);
+	pool->release(second);
+}
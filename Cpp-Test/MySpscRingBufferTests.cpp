@@ -0,0 +1,171 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct MySpscRingBufferTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MySpscRingBuffer<int>> ring;
+
+	void SetUp() override
+	{
+		ring = std::make_unique<MySpscRingBuffer<int>>(6);
+	}
+
+	void TearDown() override
+	{
+		ring.reset();
+	}
+};
+
+TEST_F(MySpscRingBufferTest, WhenConstructing_ShouldRoundCapacityUpToPowerOfTwo)
+{
+	ASSERT_EQ(ring->get_capacity(), 8);
+	ASSERT_EQ(MySpscRingBuffer<int>(1).get_capacity(), 1);
+	ASSERT_THROW(MySpscRingBuffer<int>(0), std::exception);
+}
+
+TEST_F(MySpscRingBufferTest, GivenFull_WhenPushing_ShouldRefuseUntilPopped)
+{
+	for (int value = 0; value < 8; value++)
+	{
+		ASSERT_TRUE(ring->try_push(value));
+	}
+	ASSERT_FALSE(ring->try_push(8));
+	ASSERT_EQ(ring->get_count(), 8);
+
+	int popped = -1;
+	ASSERT_TRUE(ring->try_pop(popped));
+	ASSERT_EQ(popped, 0);
+	ASSERT_TRUE(ring->try_push(8));
+	for (int expected = 1; expected <= 8; expected++)
+	{
+		ASSERT_TRUE(ring->try_pop(popped));
+		ASSERT_EQ(popped, expected);
+	}
+	ASSERT_FALSE(ring->try_pop(popped));
+}
+
+TEST_F(MySpscRingBufferTest, WhenPushingAndPoppingBatchesAcrossWrap_ShouldKeepOrderAndStopAtBounds)
+{
+	const int first[] = { 0, 1, 2, 3, 4, 5 };
+	ASSERT_EQ(ring->try_push_n(first, 6), 6);
+	int out[8] = {};
+	ASSERT_EQ(ring->try_pop_n(out, 4), 4);
+	ASSERT_EQ(out[3], 3);
+
+	const int second[] = { 6, 7, 8, 9, 10, 11, 12, 13 };
+	ASSERT_EQ(ring->try_push_n(second, 8), 6); //wraps, and only 6 slots were free
+	ASSERT_EQ(ring->try_pop_n(out, 8), 8);
+	for (int index = 0; index < 8; index++)
+	{
+		ASSERT_EQ(out[index], index + 4);
+	}
+	ASSERT_EQ(ring->try_pop_n(out, 8), 0);
+}
+
+TEST_F(MySpscRingBufferTest, GivenItemsLeft_WhenDestroying_ShouldDestroyThem)
+{
+	auto shared = std::make_shared<int>(1);
+	{
+		MySpscRingBuffer<std::shared_ptr<int>> owners(4);
+		owners.try_push(shared);
+		owners.try_emplace(shared);
+		std::shared_ptr<int> popped;
+		owners.try_pop(popped);
+		owners.try_push(shared);
+		ASSERT_EQ(shared.use_count(), 4);
+	}
+	ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST_F(MySpscRingBufferTest, GivenCopyThrowsAfterWrap_WhenPushingBatch_ShouldPushNothingAndLeakNothing)
+{
+	struct Fussy
+	{
+		std::shared_ptr<int> token;
+		int* copies_left;
+
+		Fussy(std::shared_ptr<int> from, int* budget) : token(std::move(from)), copies_left(budget) {}
+		Fussy(const Fussy& other) : token(other.token), copies_left(other.copies_left)
+		{
+			if ((*copies_left)-- == 0) throw std::exception("copy failed");
+		}
+		Fussy(Fussy&&) = default;
+		Fussy& operator=(Fussy&&) = default;
+	};
+
+	auto token = std::make_shared<int>(1);
+	int copies_left = 0;
+	{
+		MySpscRingBuffer<Fussy> fussy(4);
+		Fussy popped(nullptr, &copies_left);
+		for (int item = 0; item < 3; item++)
+		{
+			fussy.try_emplace(token, &copies_left);
+			fussy.try_pop(popped); //moves the tail round to the last slot
+		}
+		popped.token.reset();
+
+		const Fussy batch[] = { Fussy(token, &copies_left), Fussy(token, &copies_left), Fussy(token, &copies_left) };
+		copies_left = 2; //the first run's copy and one of the wrapped run go through
+		ASSERT_THROW(fussy.try_push_n(batch, 3), std::exception);
+		ASSERT_EQ(fussy.get_count(), 0);
+		ASSERT_EQ(token.use_count(), 4);
+
+		copies_left = 3;
+		ASSERT_EQ(fussy.try_push_n(batch, 3), 3);
+		ASSERT_EQ(token.use_count(), 7);
+	}
+	ASSERT_EQ(token.use_count(), 1);
+}
+
+TEST_F(MySpscRingBufferTest, GivenTwoThreads_WhenPassingItems_ShouldArriveOnceInOrder)
+{
+	constexpr int ITEMS = 200'000;
+	std::thread producer([this]
+	{
+		int batch[5];
+		for (int next = 0; next < ITEMS; )
+		{
+			size_t pushed = 0;
+			if (next % 3 == 0) //mix single pushes in with batches
+			{
+				pushed = ring->try_push(next) ? 1 : 0;
+			}
+			else
+			{
+				const int count = std::min(5, ITEMS - next);
+				for (int index = 0; index < count; index++)
+				{
+					batch[index] = next + index;
+				}
+				pushed = ring->try_push_n(batch, count);
+			}
+			next += static_cast<int>(pushed);
+			if (pushed == 0)
+			{
+				std::this_thread::yield(); //lets the consumer in when both share a core
+			}
+		}
+	});
+
+	int expected = 0;
+	int out_of_order = 0; //counted rather than asserted so the producer is always joined
+	int out[3];
+	while (expected < ITEMS)
+	{
+		const size_t popped = ring->try_pop_n(out, 3);
+		if (popped == 0)
+		{
+			std::this_thread::yield();
+		}
+		for (size_t index = 0; index < popped; index++)
+		{
+			out_of_order += out[index] == expected++ ? 0 : 1;
+		}
+	}
+	producer.join();
+	ASSERT_EQ(out_of_order, 0);
+	ASSERT_EQ(ring->get_count(), 0);
+}
@@ -0,0 +1,84 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct MyThreadPoolTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyThreadPool> pool;
+
+	void SetUp() override
+	{
+		pool = std::make_unique<MyThreadPool>(4);
+	}
+
+	void TearDown() override
+	{
+		pool.reset();
+	}
+};
+
+//sums the leaves of a binary tree of parallel_for calls depth levels deep
+int64_t count_leaves(MyThreadPool& pool, int depth)
+{
+	if (depth == 0)
+	{
+		return 1;
+	}
+	std::atomic<int64_t> leaves = 0;
+	pool.parallel_for(0, 2, [&](int64_t) { leaves.fetch_add(count_leaves(pool, depth - 1)); });
+	return leaves.load();
+}
+
+TEST_F(MyThreadPoolTest, WhenConstructing_ShouldNeedAThread)
+{
+	ASSERT_EQ(pool->get_thread_count(), 4);
+	ASSERT_THROW(MyThreadPool(0), std::exception);
+}
+
+TEST_F(MyThreadPoolTest, WhenSubmitting_ShouldReturnResultOrException)
+{
+	std::future<int> answer = pool->submit([] { return 42; });
+	std::future<void> failure = pool->submit([] { throw std::exception("task failed"); });
+	ASSERT_EQ(answer.get(), 42);
+	ASSERT_THROW(failure.get(), std::exception);
+}
+
+TEST_F(MyThreadPoolTest, WhenParallelFor_ShouldVisitEachIndexOnce)
+{
+	std::vector<std::atomic<int>> visits(10'000);
+	pool->parallel_for(0, 10'000, [&](int64_t index) { visits[index].fetch_add(1); }, 16);
+	for (std::atomic<int>& count : visits)
+	{
+		ASSERT_EQ(count.load(), 1);
+	}
+	pool->parallel_for(5, 5, [&](int64_t) { FAIL(); });
+	ASSERT_THROW(pool->parallel_for(0, 1, [](int64_t) {}, 0), std::exception);
+}
+
+TEST_F(MyThreadPoolTest, GivenNestedParallelFor_WhenRunning_ShouldFinishEveryBranch)
+{
+	ASSERT_EQ(count_leaves(*pool, 12), 4096);
+}
+
+TEST_F(MyThreadPoolTest, GivenBodyThrows_WhenParallelFor_ShouldFinishRangeThenRethrow)
+{
+	std::atomic<int> visited = 0;
+	ASSERT_THROW(pool->parallel_for(0, 1000, [&](int64_t index)
+	{
+		visited.fetch_add(1);
+		if (index == 500) throw std::exception("body failed");
+	}), std::exception);
+	ASSERT_EQ(visited.load(), 1000);
+}
+
+TEST_F(MyThreadPoolTest, GivenTasksQueued_WhenDestroying_ShouldRunThemFirst)
+{
+	std::atomic<int> ran = 0;
+	for (int task = 0; task < 1000; task++)
+	{
+		pool->submit([&] { ran.fetch_add(1); });
+	}
+	pool.reset();
+	ASSERT_EQ(ran.load(), 1000);
+}
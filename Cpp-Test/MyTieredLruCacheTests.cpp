@@ -0,0 +1,220 @@
+#include "pch.h"
+
+using namespace ds;
+
+//the mapping removes the file again once it is closed
+static string scratch_path(const char* name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(MySlabAllocatorTest, WhenSizing_ShouldPickSmallestChunkThatFits)
+{
+	MySlabAllocator slabs(4 * SLAB_PAGE_SIZE);
+	ASSERT_EQ(slabs.chunk_size(slabs.class_for(1)), SLAB_MIN_CHUNK);
+	const int size_class = slabs.class_for(1000);
+	ASSERT_GE(slabs.chunk_size(size_class), 1000);
+	ASSERT_LT(slabs.chunk_size(size_class - 1), 1000);
+	ASSERT_EQ(slabs.chunk_size(slabs.class_for(SLAB_PAGE_SIZE)), SLAB_PAGE_SIZE);
+	ASSERT_EQ(slabs.class_for(SLAB_PAGE_SIZE + 1), -1);
+}
+
+TEST(MySlabAllocatorTest, GivenEveryPageTaken_WhenAllocating_ShouldOnlyReuseReleasedChunks)
+{
+	MySlabAllocator slabs(2 * SLAB_PAGE_SIZE);
+	const int whole_page = slabs.class_for(SLAB_PAGE_SIZE);
+	uint64_t first = 0;
+	uint64_t second = 0;
+	uint64_t third = 0;
+	ASSERT_TRUE(slabs.allocate(whole_page, first));
+	ASSERT_TRUE(slabs.allocate(whole_page, second));
+	ASSERT_NE(first, second);
+	ASSERT_FALSE(slabs.allocate(whole_page, third));
+	ASSERT_FALSE(slabs.allocate(slabs.class_for(1), third));
+
+	slabs.release(whole_page, first);
+	ASSERT_TRUE(slabs.allocate(whole_page, third));
+	ASSERT_EQ(third, first);
+	ASSERT_EQ(slabs.get_pages_used(), 2);
+}
+
+TEST(MySlabAllocatorTest, GivenLessThanAPage_WhenConstructing_ShouldThrow)
+{
+	ASSERT_THROW(MySlabAllocator(SLAB_PAGE_SIZE - 1), std::exception);
+	ASSERT_THROW((MyMappedCacheTier<int, string>(scratch_path("mapped_cache_tier_small.bin"), SLAB_PAGE_SIZE / 2)), std::exception);
+}
+
+struct MyMappedCacheTierTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyMappedCacheTier<int, string>> tier;
+
+	void SetUp() override
+	{
+		tier = std::make_unique<MyMappedCacheTier<int, string>>(scratch_path("mapped_cache_tier_test.bin"), 2 * SLAB_PAGE_SIZE);
+	}
+
+	void TearDown() override
+	{
+		tier.reset();
+	}
+};
+
+TEST_F(MyMappedCacheTierTest, WhenTaking_ShouldReadValueBackAndForgetIt)
+{
+	ASSERT_TRUE(tier->put(1, "one"));
+	ASSERT_TRUE(tier->put(2, string(5000, 'x')));
+	ASSERT_TRUE(tier->put(1, "uno"));
+	ASSERT_EQ(tier->size(), 2);
+
+	string value;
+	ASSERT_TRUE(tier->take(1, value));
+	ASSERT_EQ(value, "uno");
+	ASSERT_FALSE(tier->contains(1));
+	ASSERT_FALSE(tier->take(1, value));
+	ASSERT_TRUE(tier->take(2, value));
+	ASSERT_EQ(value, string(5000, 'x'));
+	ASSERT_EQ(tier->size(), 0);
+}
+
+TEST_F(MyMappedCacheTierTest, GivenSizeClassFull_WhenPutting_ShouldEvictItsLeastRecent)
+{
+	//a third of a page rounds up to a chunk that fits twice in each of the two pages
+	const string third_page(SLAB_PAGE_SIZE / 3, 't');
+	for (int key = 0; key < 5; key++)
+	{
+		ASSERT_TRUE(tier->put(key, third_page));
+	}
+	ASSERT_EQ(tier->size(), 4);
+	ASSERT_FALSE(tier->contains(0));
+	ASSERT_TRUE(tier->contains(4));
+
+	ASSERT_FALSE(tier->put(9, "small")); //every page went to the third of a page class
+	ASSERT_FALSE(tier->put(10, string(SLAB_PAGE_SIZE, 'b')));
+}
+
+TEST_F(MyMappedCacheTierTest, GivenReplacementDoesNotFit_WhenPutting_ShouldKeepOldValue)
+{
+	ASSERT_TRUE(tier->put(1, "one"));
+	ASSERT_FALSE(tier->put(1, string(SLAB_PAGE_SIZE + 1, 'x'))); //bigger than any chunk
+
+	const string third_page(SLAB_PAGE_SIZE / 3, 't');
+	for (int key = 2; key < 5; key++)
+	{
+		ASSERT_TRUE(tier->put(key, third_page)); //the rest of the file goes to the third of a page class
+	}
+	ASSERT_FALSE(tier->put(1, string(SLAB_PAGE_SIZE / 8, 'y'))); //a class that never got a page
+
+	string value;
+	ASSERT_TRUE(tier->take(1, value));
+	ASSERT_EQ(value, "one");
+}
+
+struct MyTieredLruCacheTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyTieredLruCache<int, string>> cache;
+
+	void SetUp() override
+	{
+		cache = std::make_unique<MyTieredLruCache<int, string>>(scratch_path("tiered_lru_cache_test.bin"), 2 * SLAB_PAGE_SIZE);
+		cache->set_capacity(2);
+	}
+
+	void TearDown() override
+	{
+		cache.reset();
+	}
+};
+
+TEST_F(MyTieredLruCacheTest, GivenEvicted_WhenGetting_ShouldPromoteFromMappedTier)
+{
+	for (int key = 0; key < 10; key++)
+	{
+		cache->put(key, std::to_string(key));
+	}
+	ASSERT_EQ(cache->get_memory_size(), 2);
+	ASSERT_EQ(cache->get_mapped_size(), 8);
+	ASSERT_EQ(cache->get_demotions(), 8);
+
+	ASSERT_EQ(cache->get(3), "3");
+	ASSERT_EQ(cache->get_promotions(), 1);
+	ASSERT_EQ(cache->get_memory_size(), 2); //3 came up and the least recent went down in its place
+	ASSERT_EQ(cache->size(), 10);
+	for (int key = 0; key < 10; key++)
+	{
+		ASSERT_EQ(cache->get(key), std::to_string(key));
+	}
+	string missing;
+	ASSERT_FALSE(cache->try_get(10, missing));
+}
+
+TEST_F(MyTieredLruCacheTest, GivenDemoted_WhenPutting_ShouldNotPromoteStaleValue)
+{
+	for (int key = 0; key < 3; key++)
+	{
+		cache->put(key, std::to_string(key));
+	}
+	ASSERT_EQ(cache->get_mapped_size(), 1);
+
+	cache->put(0, string("zero"));
+	ASSERT_EQ(cache->get(0), "zero");
+	ASSERT_EQ(cache->get_promotions(), 0);
+}
+
+TEST_F(MyTieredLruCacheTest, WhenRemoving_ShouldRemoveFromEitherTierWithoutDemoting)
+{
+	for (int key = 0; key < 3; key++)
+	{
+		cache->put(key, std::to_string(key));
+	}
+	cache->remove(0); //in the mapped tier
+	cache->remove(2); //in memory
+	ASSERT_FALSE(cache->contains(0));
+	ASSERT_FALSE(cache->contains(2));
+	ASSERT_TRUE(cache->contains(1));
+	ASSERT_EQ(cache->get_demotions(), 1);
+	ASSERT_THROW(cache->remove(2), std::exception);
+}
+
+//no default constructor, and copies can be made to throw
+struct Fragile
+{
+	static bool copies_throw;
+	int value;
+
+	explicit Fragile(int from) : value(from) {}
+	Fragile(const Fragile& other) : value(other.value)
+	{
+		if (copies_throw) throw std::exception("copy failed");
+	}
+	Fragile(Fragile&&) = default;
+	Fragile& operator=(const Fragile&) = default;
+	Fragile& operator=(Fragile&&) = default;
+};
+
+bool Fragile::copies_throw = false;
+
+struct FragileSerializer
+{
+	static void write(std::ostream& out, const Fragile& fragile) { SnapshotSerializer<int>::write(out, fragile.value); }
+	static Fragile read(std::istream& in) { return Fragile(SnapshotSerializer<int>::read(in)); }
+};
+
+TEST(MyTieredLruCacheFragileTest, GivenPromotionPutThrows_WhenGetting_ShouldKeepValueInMappedTier)
+{
+	MyTieredLruCache<int, Fragile, LruPolicy, NoCacheStats, FragileSerializer> cache(scratch_path("tiered_lru_cache_fragile.bin"), 2 * SLAB_PAGE_SIZE);
+	cache.set_capacity(1);
+	cache.put(1, Fragile(1));
+	cache.put(2, Fragile(2));
+	ASSERT_EQ(cache.get_mapped_size(), 1);
+
+	Fragile::copies_throw = true;
+	ASSERT_THROW(cache.get(1), std::exception);
+	Fragile::copies_throw = false;
+	ASSERT_TRUE(cache.contains(1));
+
+	ASSERT_EQ(cache.get(1).value, 1);
+	ASSERT_EQ(cache.get(2).value, 2);
+	ASSERT_EQ(cache.size(), 2);
+}
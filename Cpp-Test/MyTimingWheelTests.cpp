@@ -0,0 +1,100 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct TimerEntry : public MyTimingWheel<TimerEntry>::Hook
+{
+	int id = 0;
+};
+
+struct MyTimingWheelTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyTimingWheel<TimerEntry>> wheel;
+	std::vector<TimerEntry> entries;
+	std::vector<int> fired;
+
+	void SetUp() override
+	{
+		wheel = std::make_unique<MyTimingWheel<TimerEntry>>();
+		entries.resize(8);
+		for (int index = 0; index < 8; index++)
+		{
+			entries[index].id = index;
+		}
+	}
+
+	void TearDown() override
+	{
+		wheel.reset();
+	}
+
+	void advance(uint64_t now)
+	{
+		wheel->advance(now, [this](TimerEntry& entry) { fired.push_back(entry.id); });
+	}
+};
+
+TEST_F(MyTimingWheelTest, WhenAdvancingToExpiry_ShouldFireOnThatTick)
+{
+	wheel->schedule(entries[0], 10);
+
+	advance(9);
+	ASSERT_TRUE(fired.empty());
+
+	advance(10);
+	ASSERT_EQ(fired, std::vector<int>{ 0 });
+	ASSERT_TRUE(wheel->is_empty());
+	ASSERT_EQ(entries[0].expires_at, 0);
+}
+
+TEST_F(MyTimingWheelTest, GivenCancelled_WhenAdvancing_ShouldNotFire)
+{
+	wheel->schedule(entries[0], 10);
+	wheel->schedule(entries[1], 10);
+	wheel->cancel(entries[0]);
+	ASSERT_EQ(wheel->size(), 1);
+
+	advance(20);
+	ASSERT_EQ(fired, std::vector<int>{ 1 });
+}
+
+TEST_F(MyTimingWheelTest, GivenLongDelays_WhenAdvancing_ShouldCascadeAndFireOnTime)
+{
+	const uint64_t delays[] = { 63, 64, 65, 4095, 4096, 300000, 16777216, 40000000 };
+	for (int index = 0; index < 8; index++)
+	{
+		wheel->schedule(entries[index], delays[index]);
+	}
+
+	for (int index = 0; index < 8; index++)
+	{
+		advance(delays[index] - 1);
+		ASSERT_EQ(fired.size(), index);
+		advance(delays[index]);
+		ASSERT_EQ(fired.size(), index + 1);
+		ASSERT_EQ(fired.back(), index);
+	}
+}
+
+TEST_F(MyTimingWheelTest, GivenScheduled_WhenRescheduling_ShouldOnlyFireAtNewExpiry)
+{
+	wheel->schedule(entries[0], 10);
+	wheel->schedule(entries[0], 100);
+	ASSERT_EQ(wheel->size(), 1);
+
+	advance(50);
+	ASSERT_TRUE(fired.empty());
+
+	advance(100);
+	ASSERT_EQ(fired, std::vector<int>{ 0 });
+}
+
+TEST_F(MyTimingWheelTest, GivenExpiryInThePast_WhenAdvancing_ShouldFireOnNextTick)
+{
+	advance(500);
+	wheel->schedule(entries[0], 100);
+
+	advance(501);
+	ASSERT_EQ(fired, std::vector<int>{ 0 });
+}
@@ -0,0 +1,126 @@
+#include "pch.h"
+
+using namespace ds;
+
+struct MyWorkStealingDequeTest : public ::testing::Test
+{
+protected:
+	std::unique_ptr<MyWorkStealingDeque<int>> deque;
+
+	void SetUp() override
+	{
+		deque = std::make_unique<MyWorkStealingDeque<int>>(4);
+	}
+
+	void TearDown() override
+	{
+		deque.reset();
+	}
+};
+
+TEST_F(MyWorkStealingDequeTest, WhenPopping_ShouldTakeNewestAndStealingOldest)
+{
+	int item = -1;
+	ASSERT_FALSE(deque->try_pop(item));
+	ASSERT_FALSE(deque->try_steal(item));
+	for (int value = 0; value < 4; value++)
+	{
+		deque->push(value);
+	}
+	ASSERT_TRUE(deque->try_pop(item));
+	ASSERT_EQ(item, 3);
+	ASSERT_TRUE(deque->try_steal(item));
+	ASSERT_EQ(item, 0);
+	ASSERT_EQ(deque->get_count(), 2);
+	ASSERT_TRUE(deque->try_pop(item));
+	ASSERT_EQ(item, 2);
+	ASSERT_TRUE(deque->try_pop(item));
+	ASSERT_EQ(item, 1);
+	ASSERT_FALSE(deque->try_pop(item));
+	ASSERT_EQ(deque->get_count(), 0);
+}
+
+TEST_F(MyWorkStealingDequeTest, GivenWrappedAround_WhenGrowing_ShouldKeepOrder)
+{
+	int item = -1;
+	for (int value = 0; value < 3; value++)
+	{
+		deque->push(value);
+	}
+	deque->try_steal(item);
+	deque->try_steal(item); //top is now 2 into the ring of 4
+	for (int value = 3; value < 100; value++)
+	{
+		deque->push(value);
+	}
+	for (int expected = 2; expected < 50; expected++)
+	{
+		ASSERT_TRUE(deque->try_steal(item));
+		ASSERT_EQ(item, expected);
+	}
+	for (int expected = 99; expected >= 50; expected--)
+	{
+		ASSERT_TRUE(deque->try_pop(item));
+		ASSERT_EQ(item, expected);
+	}
+	ASSERT_FALSE(deque->try_steal(item));
+}
+
+TEST_F(MyWorkStealingDequeTest, GivenThieves_WhenOwnerPushesAndPops_ShouldHandOutEachItemOnce)
+{
+	constexpr int ITEMS = 100'000;
+	constexpr int THIEVES = 3;
+	std::vector<std::atomic<int>> arrivals(ITEMS);
+	std::atomic<int> taken = 0;
+	std::vector<std::thread> thieves;
+	for (int thief = 0; thief < THIEVES; thief++)
+	{
+		thieves.emplace_back([&]
+		{
+			int item = 0;
+			while (taken.load() < ITEMS)
+			{
+				if (deque->try_steal(item))
+				{
+					arrivals[item].fetch_add(1);
+					taken.fetch_add(1);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	//the owner keeps the deque short so it often races the thieves for the last item
+	int item = 0;
+	for (int value = 0; value < ITEMS; value++)
+	{
+		deque->push(value);
+		if (value % 3 == 0 && deque->try_pop(item))
+		{
+			arrivals[item].fetch_add(1);
+			taken.fetch_add(1);
+		}
+	}
+	while (taken.load() < ITEMS)
+	{
+		if (deque->try_pop(item))
+		{
+			arrivals[item].fetch_add(1);
+			taken.fetch_add(1);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	for (std::thread& thief : thieves)
+	{
+		thief.join();
+	}
+	for (std::atomic<int>& count : arrivals)
+	{
+		ASSERT_EQ(count.load(), 1);
+	}
+}
@@ -9,7 +9,25 @@
 #include "../Cpp/MyDynamicList.h"
 #include "../Cpp/MyLinkedList.h"
 #include "../Cpp/MyArrayDeque.h"
+#include "../Cpp/MyBlockDeque.h"
+#include "../Cpp/MySpscRingBuffer.h"
+#include "../Cpp/MyMpmcQueue.h"
+#include "../Cpp/MyWorkStealingDeque.h"
+#include "../Cpp/MyThreadPool.h"
+#include "../Cpp/MyCountMinSketch.h"
+#include "../Cpp/MyCacheStats.h"
+#include "../Cpp/MyTimingWheel.h"
+#include "../Cpp/MyFlatHashMap.h"
+#include "../Cpp/MyObjectPool.h"
+#include "../Cpp/MyCacheSnapshot.h"
+#include "../Cpp/MyCachePolicies.h"
 #include "../Cpp/MyLruCache.h"
+#include "../Cpp/MyConcurrentLruCache.h"
+#include "../Cpp/MySlabAllocator.h"
+#include "../Cpp/MyMappedCacheTier.h"
+#include "../Cpp/MyTieredLruCache.h"
 #include "../Cpp/MyTrie.h"
 #include "MemoryLeakDetector.h"
-#include <functional>
\ No newline at end of file
+#include <filesystem>
+#include <functional>
+#include <thread>
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <utility>
 namespace ds
 {
 	template<typename Type>
@@ -23,18 +24,29 @@ namespace ds
 		virtual int get_count() = 0;
 	};
 
+	//remove_first and remove_last hand back a reference that is only good until the deque next changes,
+	//take_first and take_last move the item out instead
 	template<typename Type>
 	class IDeque : public IStack<Type>, public IQueue<Type>
 	{
 	public:
 		virtual void add_last(const Type&) = 0;
+		virtual void add_last(Type&&) = 0;
 		virtual const Type& remove_last() = 0;
+		virtual Type take_last() = 0;
 		const Type& peek_last() override = 0;
 
 		virtual void add_first(const Type&) = 0;
+		virtual void add_first(Type&&) = 0;
 		virtual const Type& remove_first() = 0;
+		virtual Type take_first() = 0;
 		const Type& peek_first() override = 0;
 
+		template<typename... TArgs>
+		void emplace_last(TArgs&&... args);
+		template<typename... TArgs>
+		void emplace_first(TArgs&&... args);
+
 		int get_count() override = 0;
 
 		void offer(const Type&) final;
@@ -46,6 +58,22 @@ namespace ds
 
 	};
 
+	//through the interface the item is built and then moved in, the implementations hide this with
+	//their own emplace_last that builds it in place
+	template <typename Type>
+	template <typename... TArgs>
+	void IDeque<Type>::emplace_last(TArgs&&... args)
+	{
+		add_last(Type(std::forward<TArgs>(args)...));
+	}
+
+	template <typename Type>
+	template <typename... TArgs>
+	void IDeque<Type>::emplace_first(TArgs&&... args)
+	{
+		add_first(Type(std::forward<TArgs>(args)...));
+	}
+
 	template <typename Type>
 	void IDeque<Type>::offer(const Type& item)
 	{
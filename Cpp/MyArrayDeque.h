@@ -1,33 +1,71 @@
 #pragma once
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
 #include "Interfaces.h"
 
 
+//a ring buffer whose capacity is always a power of two, so positions wrap with a mask instead of a division
+//front_ is the slot of the first item and always lies in [0, capacity_), the last item sits count_ - 1 slots after it
+//the slots are raw storage, only the count_ live items are ever constructed, so Type needn't be default constructible
+//
+//add_last_range, remove_first_n and contiguous_spans work on whole batches, with no virtual call per item,
+//and trivially copyable items go in and out with at most two memcpys, one either side of the wrap
 template<typename Type>
 class MyArrayDeque final : public ds::IDeque<Type>
 {
 public:
+	//count items in a row starting at data
+	struct Span
+	{
+		Type* data;
+		int count;
+	};
+
 	MyArrayDeque();
+	MyArrayDeque(const MyArrayDeque&) = delete;
+	MyArrayDeque& operator=(const MyArrayDeque&) = delete;
 private:
 	Type* array_;
 	int capacity_ = 4;
+	int mask_ = 3;
 	int front_ = 0;
-	int back_ = 0;
 	int count_ = 0;
+	std::optional<Type> removed_; //the item remove_* last handed out a reference to, its slot is already free
 public:
 	void add_last(const Type&) override;
+	void add_last(Type&&) override;
+	template<typename... TArgs>
+	void emplace_last(TArgs&&... args);
 	const Type& remove_last() override;
+	Type take_last() override;
 	const Type& peek_last() override;
 
 	void add_first(const Type&) override;
+	void add_first(Type&&) override;
+	template<typename... TArgs>
+	void emplace_first(TArgs&&... args);
 	const Type& remove_first() override;
+	Type take_first() override;
 	const Type& peek_first() override;
 
+	void add_last_range(const Type* items, int count);
+	int remove_first_n(Type* out_items, int count);
+	std::pair<Span, Span> contiguous_spans();
+
 	int get_count() override;
 
 	~MyArrayDeque() override;
 
 private:
-	void ensure_capacity();
+	template<typename... TArgs>
+	void grow(int new_slot, TArgs&&... args);
+	void relocate_into(Type* grown, int new_capacity, int added_from, int added_count);
+	static void copy_run(const Type* items, int count, Type* destination);
+	void destroy_items();
 	int last_index() const;
 	int first_index() const;
 
@@ -36,37 +74,63 @@ private:
 template <typename Type>
 MyArrayDeque<Type>::MyArrayDeque()
 {
-	array_ = new Type [4];
+	array_ = std::allocator<Type>().allocate(4);
 	capacity_ = 4;
+	mask_ = capacity_ - 1;
 }
 
+//O(1) amortised
 template <typename Type>
 void MyArrayDeque<Type>::add_last(const Type& data)
 {
-	if (count_ != 0)
+	emplace_last(data);
+}
+
+//O(1) amortised
+template <typename Type>
+void MyArrayDeque<Type>::add_last(Type&& data)
+{
+	emplace_last(std::move(data));
+}
+
+//O(1) amortised
+template <typename Type>
+template <typename... TArgs>
+void MyArrayDeque<Type>::emplace_last(TArgs&&... args)
+{
+	if (count_ == capacity_)
 	{
-		++back_;
+		grow(count_, std::forward<TArgs>(args)...);
+	}
+	else
+	{
+		new (&array_[(front_ + count_) & mask_]) Type(std::forward<TArgs>(args)...);
 	}
 	++count_;
-	ensure_capacity();
-	Type copy = data;
-	array_[last_index()] = copy;
-	
 }
 
+//O(1)
+//the item is moved out of its slot so the slot can be reused straight away
 template <typename Type>
 const Type& MyArrayDeque<Type>::remove_last()
+{
+	removed_.emplace(take_last());
+	return *removed_;
+}
+
+//O(1)
+template <typename Type>
+Type MyArrayDeque<Type>::take_last()
 {
 	if (get_count() == 0) throw std::exception("empty deque");
-	const Type& result = array_[last_index()];
-	if (count_ != 1)
-	{
-		--back_;
-	}
+	Type& slot = array_[last_index()];
+	Type result = std::move(slot);
+	slot.~Type();
 	--count_;
 	return result;
 }
 
+//O(1)
 template <typename Type>
 const Type& MyArrayDeque<Type>::peek_last()
 {
@@ -75,33 +139,61 @@ const Type& MyArrayDeque<Type>::peek_last()
 	return result;
 }
 
+//O(1) amortised
 template <typename Type>
 void MyArrayDeque<Type>::add_first(const Type& data)
 {
-	if (count_ != 0)
+	emplace_first(data);
+}
+
+//O(1) amortised
+template <typename Type>
+void MyArrayDeque<Type>::add_first(Type&& data)
+{
+	emplace_first(std::move(data));
+}
+
+//O(1) amortised
+template <typename Type>
+template <typename... TArgs>
+void MyArrayDeque<Type>::emplace_first(TArgs&&... args)
+{
+	if (count_ == capacity_)
 	{
-		--front_;
+		grow(capacity_ * 2 - 1, std::forward<TArgs>(args)...);
+		front_ = mask_;
+	}
+	else
+	{
+		const int slot = (front_ - 1) & mask_;
+		new (&array_[slot]) Type(std::forward<TArgs>(args)...);
+		front_ = slot;
 	}
 	++count_;
-	ensure_capacity();
-	Type copy = data;
-	array_[first_index()] = copy;
-	
 }
 
+//O(1)
 template <typename Type>
 const Type& MyArrayDeque<Type>::remove_first()
+{
+	removed_.emplace(take_first());
+	return *removed_;
+}
+
+//O(1)
+template <typename Type>
+Type MyArrayDeque<Type>::take_first()
 {
 	if (get_count() == 0) throw std::exception("empty deque");
-	const Type& result = array_[first_index()];
-	if (count_ != 1)
-	{
-		++front_;
-	}
+	Type& slot = array_[first_index()];
+	Type result = std::move(slot);
+	slot.~Type();
+	front_ = (front_ + 1) & mask_;
 	--count_;
 	return result;
 }
 
+//O(1)
 template <typename Type>
 const Type& MyArrayDeque<Type>::peek_first()
 {
@@ -110,6 +202,78 @@ const Type& MyArrayDeque<Type>::peek_first()
 	return result;
 }
 
+//O(count) amortised
+//grows at most once, items may point into this deque, they are copied before any item moves
+template <typename Type>
+void MyArrayDeque<Type>::add_last_range(const Type* items, int count)
+{
+	if (count < 0) throw std::exception("count can't be negative");
+	if (count_ + count > capacity_)
+	{
+		int new_capacity = capacity_ * 2;
+		while (new_capacity < count_ + count)
+		{
+			new_capacity *= 2;
+		}
+		Type* grown = std::allocator<Type>().allocate(new_capacity);
+		try
+		{
+			copy_run(items, count, grown + count_);
+		}
+		catch (...)
+		{
+			std::allocator<Type>().deallocate(grown, new_capacity);
+			throw;
+		}
+		relocate_into(grown, new_capacity, count_, count);
+		count_ += count;
+		return;
+	}
+
+	const int back = (front_ + count_) & mask_;
+	const int first_run = std::min(count, capacity_ - back);
+	copy_run(items, first_run, array_ + back);
+	count_ += first_run;
+	copy_run(items + first_run, count - first_run, array_);
+	count_ += count - first_run;
+}
+
+//O(count)
+//moves up to count items from the front into out_items, which must hold count constructed items,
+//and returns how many it moved, 0 when empty rather than throwing
+template <typename Type>
+int MyArrayDeque<Type>::remove_first_n(Type* out_items, int count)
+{
+	if (count < 0) throw std::exception("count can't be negative");
+	const int removed = std::min(count, count_);
+	const int first_run = std::min(removed, capacity_ - front_);
+	if constexpr (std::is_trivially_copyable_v<Type>)
+	{
+		std::memcpy(out_items, array_ + front_, sizeof(Type) * first_run);
+		std::memcpy(out_items + first_run, array_, sizeof(Type) * (removed - first_run));
+	}
+	else
+	{
+		std::move(array_ + front_, array_ + front_ + first_run, out_items);
+		std::destroy(array_ + front_, array_ + front_ + first_run);
+		std::move(array_, array_ + (removed - first_run), out_items + first_run);
+		std::destroy(array_, array_ + (removed - first_run));
+	}
+	front_ = (front_ + removed) & mask_;
+	count_ -= removed;
+	return removed;
+}
+
+//O(1)
+//the live items front to back, first then second, second is empty unless the items wrap
+//only good until the deque next changes
+template <typename Type>
+std::pair<typename MyArrayDeque<Type>::Span, typename MyArrayDeque<Type>::Span> MyArrayDeque<Type>::contiguous_spans()
+{
+	const int first_run = std::min(count_, capacity_ - front_);
+	return { Span{ array_ + front_, first_run }, Span{ array_, count_ - first_run } };
+}
+
 template <typename Type>
 int MyArrayDeque<Type>::get_count()
 {
@@ -119,39 +283,110 @@ int MyArrayDeque<Type>::get_count()
 template <typename Type>
 MyArrayDeque<Type>::~MyArrayDeque()
 {
-	delete[] array_;
+	destroy_items();
+	std::allocator<Type>().deallocate(array_, capacity_);
 }
 
+//O(n)
+//doubles the capacity, which keeps it a power of two, and unwraps the items to start at slot 0
+//the new item is built at new_slot of the grown buffer first, since args may refer to one of the items that move
 template <typename Type>
-void MyArrayDeque<Type>::ensure_capacity()
+template <typename... TArgs>
+void MyArrayDeque<Type>::grow(int new_slot, TArgs&&... args)
 {
-	if(count_ <= capacity_)
+	const int new_capacity = capacity_ * 2;
+	Type* grown = std::allocator<Type>().allocate(new_capacity);
+	try
 	{
-		return;
+		new (&grown[new_slot]) Type(std::forward<TArgs>(args)...);
 	}
-	const int new_capacity = capacity_ * 2;
-	Type* copy = new Type [new_capacity];
+	catch (...)
+	{
+		std::allocator<Type>().deallocate(grown, new_capacity);
+		throw;
+	}
+
+	relocate_into(grown, new_capacity, new_slot, 1);
+}
 
-	for (int index = 0; index < capacity_; index++)
+//O(n)
+//moves the items to the start of grown, which becomes the ring
+//the items sit in at most two runs, either side of the wrap, so trivially copyable ones go across in two memcpys
+//the added_count items the caller already built at added_from are the new ones, if moving an item throws they are
+//destroyed with everything moved so far and grown is handed back, the deque is left as it was
+//items whose move constructor can throw are copied instead when they can be, as std::vector does, otherwise the
+//ones already moved out of are left moved from
+template <typename Type>
+void MyArrayDeque<Type>::relocate_into(Type* grown, int new_capacity, int added_from, int added_count)
+{
+	const int first_run = std::min(count_, capacity_ - front_);
+	if constexpr (std::is_trivially_copyable_v<Type>)
 	{
-		int old_index = (front_ + index + capacity_) % capacity_;
-		copy[index] = array_[old_index];
+		std::memcpy(grown, array_ + front_, sizeof(Type) * first_run);
+		std::memcpy(grown + first_run, array_, sizeof(Type) * (count_ - first_run));
 	}
-	back_ -= front_;
-	front_ = 0;
-	delete[] array_;
-	array_ = copy;
+	else
+	{
+		int moved = 0;
+		try
+		{
+			for (; moved < count_; moved++)
+			{
+				new (&grown[moved]) Type(std::move_if_noexcept(array_[(front_ + moved) & mask_]));
+			}
+		}
+		catch (...)
+		{
+			std::destroy(grown, grown + moved);
+			std::destroy(grown + added_from, grown + added_from + added_count);
+			std::allocator<Type>().deallocate(grown, new_capacity);
+			throw;
+		}
+		destroy_items();
+	}
+	std::allocator<Type>().deallocate(array_, capacity_);
+	array_ = grown;
 	capacity_ = new_capacity;
+	mask_ = new_capacity - 1;
+	front_ = 0;
+}
+
+//O(count)
+//copy constructs count items into raw storage
+template <typename Type>
+void MyArrayDeque<Type>::copy_run(const Type* items, int count, Type* destination)
+{
+	if constexpr (std::is_trivially_copyable_v<Type>)
+	{
+		std::memcpy(destination, items, sizeof(Type) * count);
+	}
+	else
+	{
+		std::uninitialized_copy_n(items, count, destination);
+	}
+}
+
+//O(n)
+//the live items, the storage stays
+template <typename Type>
+void MyArrayDeque<Type>::destroy_items()
+{
+	if constexpr (!std::is_trivially_destructible_v<Type>)
+	{
+		const int first_run = std::min(count_, capacity_ - front_);
+		std::destroy(array_ + front_, array_ + front_ + first_run);
+		std::destroy(array_, array_ + (count_ - first_run));
+	}
 }
 
 template <typename Type>
 int MyArrayDeque<Type>::last_index() const
 {
-	return (back_ + capacity_) % capacity_;
+	return (front_ + count_ - 1) & mask_;
 }
 
 template <typename Type>
 int MyArrayDeque<Type>::first_index() const
 {
-	return (front_ + capacity_) % capacity_;
-}
\ No newline at end of file
+	return front_;
+}
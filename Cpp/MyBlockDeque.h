@@ -0,0 +1,354 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "Interfaces.h"
+
+
+//a deque kept in fixed size blocks of about 4KB, found through a ring of block pointers, the map
+//the items are numbered around a ring of map_capacity_ * BLOCK_ITEMS positions, a position's block is its top bits
+//and its slot in the block the bottom ones, so indexing is a shift, a mask and one extra load, still O(1)
+//
+//growing only doubles the map, which copies one pointer per block rather than every item, so an add never stalls
+//on moving millions of items like MyArrayDeque's doubling does, and items never move, a reference stays good until
+//that item is removed
+//a block is handed back once its last item goes, up to SPARE_BLOCKS of them are kept for the next block needed, so a
+//deque used as a queue reaches a steady state with no allocation at all
+//the map is grown while there is still a block's worth of positions spare, so the first and last items never end up
+//sharing a block from opposite sides of the ring
+template<typename Type>
+class MyBlockDeque final : public ds::IDeque<Type>
+{
+	static constexpr int BLOCK_BYTES = 4096;
+	static constexpr int SPARE_BLOCKS = 4;
+
+	//as many items as fit in BLOCK_BYTES rounded down to a power of two, and at least 16
+	static constexpr int block_shift()
+	{
+		int shift = 4;
+		while ((sizeof(Type) << (shift + 1)) <= BLOCK_BYTES)
+		{
+			++shift;
+		}
+		return shift;
+	}
+
+	static constexpr int BLOCK_SHIFT = block_shift();
+	static constexpr int BLOCK_ITEMS = 1 << BLOCK_SHIFT;
+	static constexpr int BLOCK_MASK = BLOCK_ITEMS - 1;
+
+public:
+	MyBlockDeque();
+	MyBlockDeque(const MyBlockDeque&) = delete;
+	MyBlockDeque& operator=(const MyBlockDeque&) = delete;
+private:
+	Type** map_; //null where a block holds no live item
+	int map_capacity_ = 4;
+	int map_mask_ = 3;
+	int front_ = 0; //the position of the first item
+	int count_ = 0;
+	Type* spare_blocks_[SPARE_BLOCKS];
+	int spare_count_ = 0;
+	std::optional<Type> removed_; //the item remove_* last handed out a reference to, its slot is already free
+public:
+	void add_last(const Type&) override;
+	void add_last(Type&&) override;
+	template<typename... TArgs>
+	void emplace_last(TArgs&&... args);
+	const Type& remove_last() override;
+	Type take_last() override;
+	const Type& peek_last() override;
+
+	void add_first(const Type&) override;
+	void add_first(Type&&) override;
+	template<typename... TArgs>
+	void emplace_first(TArgs&&... args);
+	const Type& remove_first() override;
+	Type take_first() override;
+	const Type& peek_first() override;
+
+	Type& operator[](int index);
+
+	int get_count() override;
+
+	~MyBlockDeque() override;
+
+private:
+	template<typename... TArgs>
+	void construct_at(int position, TArgs&&... args);
+	Type take_at(int position, bool block_emptied);
+	void ensure_map_room();
+	void grow_map();
+	Type* acquire_block();
+	void release_block(Type* block);
+	Type& item_at(int position) const;
+	int position_mask() const;
+	int last_position() const;
+
+};
+
+template <typename Type>
+MyBlockDeque<Type>::MyBlockDeque()
+{
+	map_ = new Type*[map_capacity_]();
+}
+
+//O(1) amortised, never more than the pointers in the map
+template <typename Type>
+void MyBlockDeque<Type>::add_last(const Type& data)
+{
+	emplace_last(data);
+}
+
+//O(1) amortised
+template <typename Type>
+void MyBlockDeque<Type>::add_last(Type&& data)
+{
+	emplace_last(std::move(data));
+}
+
+//O(1) amortised
+//items don't move when the map grows, so args may refer to one of them
+template <typename Type>
+template <typename... TArgs>
+void MyBlockDeque<Type>::emplace_last(TArgs&&... args)
+{
+	ensure_map_room();
+	construct_at((front_ + count_) & position_mask(), std::forward<TArgs>(args)...);
+	++count_;
+}
+
+//O(1)
+//the item is moved out of its slot so the slot can be reused straight away
+template <typename Type>
+const Type& MyBlockDeque<Type>::remove_last()
+{
+	removed_.emplace(take_last());
+	return *removed_;
+}
+
+//O(1)
+template <typename Type>
+Type MyBlockDeque<Type>::take_last()
+{
+	if (get_count() == 0) throw std::exception("empty deque");
+	const int position = last_position();
+	Type result = take_at(position, count_ == 1 || (position & BLOCK_MASK) == 0);
+	--count_;
+	return result;
+}
+
+//O(1)
+template <typename Type>
+const Type& MyBlockDeque<Type>::peek_last()
+{
+	if (get_count() == 0) throw std::exception("empty deque");
+	return item_at(last_position());
+}
+
+//O(1) amortised
+template <typename Type>
+void MyBlockDeque<Type>::add_first(const Type& data)
+{
+	emplace_first(data);
+}
+
+//O(1) amortised
+template <typename Type>
+void MyBlockDeque<Type>::add_first(Type&& data)
+{
+	emplace_first(std::move(data));
+}
+
+//O(1) amortised
+template <typename Type>
+template <typename... TArgs>
+void MyBlockDeque<Type>::emplace_first(TArgs&&... args)
+{
+	ensure_map_room();
+	const int position = (front_ - 1) & position_mask();
+	construct_at(position, std::forward<TArgs>(args)...);
+	front_ = position;
+	++count_;
+}
+
+//O(1)
+template <typename Type>
+const Type& MyBlockDeque<Type>::remove_first()
+{
+	removed_.emplace(take_first());
+	return *removed_;
+}
+
+//O(1)
+template <typename Type>
+Type MyBlockDeque<Type>::take_first()
+{
+	if (get_count() == 0) throw std::exception("empty deque");
+	const int position = front_;
+	Type result = take_at(position, count_ == 1 || (position & BLOCK_MASK) == BLOCK_MASK);
+	front_ = (front_ + 1) & position_mask();
+	--count_;
+	return result;
+}
+
+//O(1)
+template <typename Type>
+const Type& MyBlockDeque<Type>::peek_first()
+{
+	if (get_count() == 0) throw std::exception("empty deque");
+	return item_at(front_);
+}
+
+//O(1)
+//index 0 is the first item
+template <typename Type>
+Type& MyBlockDeque<Type>::operator[](int index)
+{
+	if (index < 0 || index >= count_) throw std::exception("index out of bounds");
+	return item_at((front_ + index) & position_mask());
+}
+
+template <typename Type>
+int MyBlockDeque<Type>::get_count()
+{
+	return count_;
+}
+
+//O(n)
+template <typename Type>
+MyBlockDeque<Type>::~MyBlockDeque()
+{
+	if constexpr (!std::is_trivially_destructible_v<Type>)
+	{
+		for (int index = 0; index < count_; index++)
+		{
+			item_at((front_ + index) & position_mask()).~Type();
+		}
+	}
+	for (int block = 0; block < map_capacity_; block++)
+	{
+		if (map_[block] != nullptr) std::allocator<Type>().deallocate(map_[block], BLOCK_ITEMS);
+	}
+	for (int spare = 0; spare < spare_count_; spare++)
+	{
+		std::allocator<Type>().deallocate(spare_blocks_[spare], BLOCK_ITEMS);
+	}
+	delete[] map_;
+}
+
+//O(1)
+//builds the item at position, taking a block for it if the position starts a new one
+//a block taken for an item whose constructor throws is handed straight back
+template <typename Type>
+template <typename... TArgs>
+void MyBlockDeque<Type>::construct_at(int position, TArgs&&... args)
+{
+	Type*& block = map_[position >> BLOCK_SHIFT];
+	if (block != nullptr)
+	{
+		new (&block[position & BLOCK_MASK]) Type(std::forward<TArgs>(args)...);
+		return;
+	}
+
+	Type* fresh = acquire_block();
+	try
+	{
+		new (&fresh[position & BLOCK_MASK]) Type(std::forward<TArgs>(args)...);
+	}
+	catch (...)
+	{
+		release_block(fresh);
+		throw;
+	}
+	block = fresh;
+}
+
+//O(1)
+//moves the item at position out, block_emptied says it was the last one in its block, which then goes back
+template <typename Type>
+Type MyBlockDeque<Type>::take_at(int position, bool block_emptied)
+{
+	Type*& block = map_[position >> BLOCK_SHIFT];
+	Type& slot = block[position & BLOCK_MASK];
+	Type result = std::move(slot);
+	slot.~Type();
+	if (block_emptied)
+	{
+		release_block(block);
+		block = nullptr;
+	}
+	return result;
+}
+
+//O(1) amortised
+template <typename Type>
+void MyBlockDeque<Type>::ensure_map_room()
+{
+	if (count_ + BLOCK_ITEMS >= (map_capacity_ << BLOCK_SHIFT))
+	{
+		grow_map();
+	}
+}
+
+//O(blocks)
+//doubles the map and unwraps it so the first item's block is block 0, the blocks themselves stay where they are
+template <typename Type>
+void MyBlockDeque<Type>::grow_map()
+{
+	const int new_capacity = map_capacity_ * 2;
+	Type** grown = new Type*[new_capacity]();
+	const int first_block = front_ >> BLOCK_SHIFT;
+	for (int block = 0; block < map_capacity_; block++)
+	{
+		grown[block] = map_[(first_block + block) & map_mask_];
+	}
+	delete[] map_;
+	map_ = grown;
+	map_capacity_ = new_capacity;
+	map_mask_ = new_capacity - 1;
+	front_ &= BLOCK_MASK;
+}
+
+//O(1)
+template <typename Type>
+Type* MyBlockDeque<Type>::acquire_block()
+{
+	if (spare_count_ > 0)
+	{
+		return spare_blocks_[--spare_count_];
+	}
+	return std::allocator<Type>().allocate(BLOCK_ITEMS);
+}
+
+//O(1)
+//the block holds no live items
+template <typename Type>
+void MyBlockDeque<Type>::release_block(Type* block)
+{
+	if (spare_count_ < SPARE_BLOCKS)
+	{
+		spare_blocks_[spare_count_++] = block;
+		return;
+	}
+	std::allocator<Type>().deallocate(block, BLOCK_ITEMS);
+}
+
+template <typename Type>
+Type& MyBlockDeque<Type>::item_at(int position) const
+{
+	return map_[position >> BLOCK_SHIFT][position & BLOCK_MASK];
+}
+
+template <typename Type>
+int MyBlockDeque<Type>::position_mask() const
+{
+	return (map_capacity_ << BLOCK_SHIFT) - 1;
+}
+
+template <typename Type>
+int MyBlockDeque<Type>::last_position() const
+{
+	return (front_ + count_ - 1) & position_mask();
+}
@@ -0,0 +1,652 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "MyCountMinSketch.h"
+#include "MyFlatHashMap.h"
+
+namespace ds
+{
+	//an eviction policy decides which entry of a MyLruCache goes when it is over capacity
+	//the cache's entry type derives from the policy's Hook, so the policy keeps its bookkeeping
+	//inside the entry instead of in side structures, TEntry has a Key type, a key and a weight
+	//
+	//	set_capacity(capacity, weighted)	the cache's capacity changed, weighted when it is a weight
+	//						budget rather than an entry count
+	//	on_insert(entry)		a new entry was added
+	//	on_access(entry)		an entry was read or its value replaced
+	//	on_miss(key)			a key was looked up but wasn't there, key can be any key-like type
+	//	on_remove(entry)		an entry is about to be erased for any reason other than eviction
+	//	pop_victim()			picks an entry to evict and forgets it, only called while over capacity
+	//	for_each_coldest_first(visit)	visits every entry, roughly in the order they'd be evicted
+	//	clear()
+
+	//doubly linked list threaded through the entries' newer/older links, also sums their weights
+	template<typename TEntry>
+	class IntrusiveList
+	{
+		TEntry* most_recent_ = nullptr;
+		TEntry* least_recent_ = nullptr;
+		size_t count_ = 0;
+		size_t weight_ = 0;
+
+	public:
+		void push_most_recent(TEntry& entry);
+		void move_to_most_recent(TEntry& entry);
+		void unlink(TEntry& entry);
+		TEntry* most_recent() const;
+		TEntry* least_recent() const;
+		size_t count() const;
+		size_t weight() const;
+		template<typename TVisit>
+		void for_each_oldest_first(TVisit visit) const;
+		void clear();
+	};
+
+	//evicts the least recently used entry, no per entry cost beyond the two links
+	template<typename TEntry>
+	class LruPolicy
+	{
+	public:
+		struct Hook
+		{
+			TEntry* newer = nullptr;
+			TEntry* older = nullptr;
+		};
+
+	private:
+		IntrusiveList<TEntry> recency_;
+
+	public:
+		void set_capacity(size_t capacity, bool weighted);
+		void on_insert(TEntry& entry);
+		void on_access(TEntry& entry);
+		template<typename TLookup>
+		void on_miss(const TLookup& key);
+		void on_remove(TEntry& entry);
+		TEntry* pop_victim();
+		template<typename TVisit>
+		void for_each_coldest_first(TVisit visit) const;
+		void clear();
+	};
+
+	//W-TinyLFU, new entries land in a small lru window, when they fall out of it they only get into
+	//the main region if the frequency sketch says they are used more than the entry they'd replace,
+	//so one off scans can't flush the hot set
+	//the main region is a segmented lru, entries hit again while on probation move up to protected
+	//the segments are sized by weight, the sketch by entry count
+	template<typename TEntry>
+	class WTinyLfuPolicy
+	{
+	public:
+		enum class Segment : uint8_t { Window, Probation, Protected };
+
+		struct Hook
+		{
+			TEntry* newer = nullptr;
+			TEntry* older = nullptr;
+			Segment segment = Segment::Window;
+		};
+
+	private:
+		static constexpr size_t WINDOW_PERCENT = 1;
+		static constexpr size_t PROTECTED_PERCENT = 80;
+
+		IntrusiveList<TEntry> window_;
+		IntrusiveList<TEntry> probation_;
+		IntrusiveList<TEntry> protected_;
+		MyCountMinSketch sketch_;
+		size_t window_capacity_ = 0;
+		size_t main_capacity_ = 0;
+		size_t protected_capacity_ = 0;
+		bool weighted_ = false;
+		size_t sketch_size_ = 0;
+
+		IntrusiveList<TEntry>& list_for(const TEntry& entry);
+		TEntry* main_victim() const;
+		int frequency(const TEntry& entry) const;
+		template<typename TLookup>
+		static uint64_t hash_of(const TLookup& key);
+
+	public:
+		void set_capacity(size_t capacity, bool weighted);
+		void on_insert(TEntry& entry);
+		void on_access(TEntry& entry);
+		template<typename TLookup>
+		void on_miss(const TLookup& key);
+		void on_remove(TEntry& entry);
+		TEntry* pop_victim();
+		template<typename TVisit>
+		void for_each_coldest_first(TVisit visit) const;
+		void clear();
+	};
+
+	//CLOCK / second chance, a hit only sets the entry's reference bit, there are no links to rewire
+	//the bits live in one flat array and eviction sweeps a hand over it, clearing set bits
+	//until it finds an entry that hasn't been used since the hand last passed
+	//
+	//the ring is a power of two circular buffer run as a queue, the hand is its head and new entries go in at
+	//the tail, so they are the last the hand reaches, a passed over entry goes back in at the tail too, which
+	//while the buffer is full is the slot it is already in, the plain clock sweep
+	//entries hold their position in the queue, positions only ever grow and are masked to a slot,
+	//a removed entry leaves a hole the hand skips, holes are squeezed out when the buffer fills
+	template<typename TEntry>
+	class ClockPolicy
+	{
+		static constexpr size_t MIN_RING_SIZE = 16;
+
+	public:
+		struct Hook
+		{
+			size_t position = 0;
+		};
+
+	private:
+		std::vector<TEntry*> ring_; //null for a hole
+		std::vector<uint8_t> referenced_;
+		size_t mask_ = 0;
+		size_t hand_ = 0; //the position of the next entry to look at
+		size_t tail_ = 0; //the position the next entry goes in at
+
+		void push(TEntry& entry);
+		void regrow();
+
+	public:
+		void set_capacity(size_t capacity, bool weighted);
+		void on_insert(TEntry& entry);
+		void on_access(TEntry& entry);
+		template<typename TLookup>
+		void on_miss(const TLookup& key);
+		void on_remove(TEntry& entry);
+		TEntry* pop_victim();
+		template<typename TVisit>
+		void for_each_coldest_first(TVisit visit) const;
+		void clear();
+	};
+
+	/*** IntrusiveList ***/
+
+	//O(1)
+	template <typename TEntry>
+	void IntrusiveList<TEntry>::push_most_recent(TEntry& entry)
+	{
+		entry.newer = nullptr;
+		entry.older = most_recent_;
+		if (most_recent_ != nullptr)
+		{
+			most_recent_->newer = &entry;
+		}
+		else
+		{
+			least_recent_ = &entry;
+		}
+		most_recent_ = &entry;
+		++count_;
+		weight_ += entry.weight;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void IntrusiveList<TEntry>::move_to_most_recent(TEntry& entry)
+	{
+		if (&entry == most_recent_)
+		{
+			return;
+		}
+		unlink(entry);
+		push_most_recent(entry);
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void IntrusiveList<TEntry>::unlink(TEntry& entry)
+	{
+		if (entry.newer != nullptr)
+		{
+			entry.newer->older = entry.older;
+		}
+		else
+		{
+			most_recent_ = entry.older;
+		}
+		if (entry.older != nullptr)
+		{
+			entry.older->newer = entry.newer;
+		}
+		else
+		{
+			least_recent_ = entry.newer;
+		}
+		entry.newer = nullptr;
+		entry.older = nullptr;
+		--count_;
+		weight_ -= entry.weight;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	TEntry* IntrusiveList<TEntry>::most_recent() const
+	{
+		return most_recent_;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	TEntry* IntrusiveList<TEntry>::least_recent() const
+	{
+		return least_recent_;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	size_t IntrusiveList<TEntry>::count() const
+	{
+		return count_;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	size_t IntrusiveList<TEntry>::weight() const
+	{
+		return weight_;
+	}
+
+	//O(n)
+	template <typename TEntry>
+	template <typename TVisit>
+	void IntrusiveList<TEntry>::for_each_oldest_first(TVisit visit) const
+	{
+		for (TEntry* entry = least_recent_; entry != nullptr; entry = entry->newer)
+		{
+			visit(*entry);
+		}
+	}
+
+	//O(1)
+	//the entries are owned by the cache, this only forgets them
+	template <typename TEntry>
+	void IntrusiveList<TEntry>::clear()
+	{
+		most_recent_ = nullptr;
+		least_recent_ = nullptr;
+		count_ = 0;
+		weight_ = 0;
+	}
+
+	/*** LruPolicy ***/
+
+	//O(1)
+	template <typename TEntry>
+	void LruPolicy<TEntry>::set_capacity(size_t, bool) {}
+
+	//O(1)
+	template <typename TEntry>
+	void LruPolicy<TEntry>::on_insert(TEntry& entry)
+	{
+		recency_.push_most_recent(entry);
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void LruPolicy<TEntry>::on_access(TEntry& entry)
+	{
+		recency_.move_to_most_recent(entry);
+	}
+
+	//O(1)
+	template <typename TEntry>
+	template <typename TLookup>
+	void LruPolicy<TEntry>::on_miss(const TLookup&) {}
+
+	//O(1)
+	template <typename TEntry>
+	void LruPolicy<TEntry>::on_remove(TEntry& entry)
+	{
+		recency_.unlink(entry);
+	}
+
+	//O(1)
+	template <typename TEntry>
+	TEntry* LruPolicy<TEntry>::pop_victim()
+	{
+		TEntry* victim = recency_.least_recent();
+		recency_.unlink(*victim);
+		return victim;
+	}
+
+	//O(n)
+	//exactly least to most recently used, so inserting in this order rebuilds the same list
+	template <typename TEntry>
+	template <typename TVisit>
+	void LruPolicy<TEntry>::for_each_coldest_first(TVisit visit) const
+	{
+		recency_.for_each_oldest_first(visit);
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void LruPolicy<TEntry>::clear()
+	{
+		recency_.clear();
+	}
+
+	/*** WTinyLfuPolicy ***/
+
+	//O(1)
+	template <typename TEntry>
+	IntrusiveList<TEntry>& WTinyLfuPolicy<TEntry>::list_for(const TEntry& entry)
+	{
+		switch (entry.segment)
+		{
+		case Segment::Window: return window_;
+		case Segment::Probation: return probation_;
+		default: return protected_;
+		}
+	}
+
+	//O(1)
+	//probation goes first, protected only holds entries that have proven themselves
+	template <typename TEntry>
+	TEntry* WTinyLfuPolicy<TEntry>::main_victim() const
+	{
+		if (probation_.least_recent() != nullptr)
+		{
+			return probation_.least_recent();
+		}
+		return protected_.least_recent();
+	}
+
+	//O(1)
+	template <typename TEntry>
+	int WTinyLfuPolicy<TEntry>::frequency(const TEntry& entry) const
+	{
+		return sketch_.frequency(hash_of(entry.key));
+	}
+
+	//O(1)
+	//a lookup by a key-like type has to land on the same counters as its key
+	template <typename TEntry>
+	template <typename TLookup>
+	uint64_t WTinyLfuPolicy<TEntry>::hash_of(const TLookup& key)
+	{
+		return static_cast<uint64_t>(LookupHash<typename TEntry::Key>{}(key));
+	}
+
+	//O(capacity) when the sketch grows
+	//O(1) otherwise
+	//a weight budget says nothing about how many entries fit, so then the sketch grows with the entries instead
+	template <typename TEntry>
+	void WTinyLfuPolicy<TEntry>::set_capacity(size_t capacity, bool weighted)
+	{
+		window_capacity_ = capacity == 0 ? 0 : std::max<size_t>(1, capacity * WINDOW_PERCENT / 100);
+		main_capacity_ = capacity - window_capacity_;
+		protected_capacity_ = main_capacity_ * PROTECTED_PERCENT / 100;
+		weighted_ = weighted;
+		if (!weighted)
+		{
+			sketch_size_ = std::max(sketch_size_, capacity);
+			sketch_.ensure_capacity(capacity);
+		}
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void WTinyLfuPolicy<TEntry>::on_insert(TEntry& entry)
+	{
+		if (weighted_)
+		{
+			const size_t entries = window_.count() + probation_.count() + protected_.count() + 1;
+			if (entries > sketch_size_)
+			{
+				sketch_size_ = entries * 2;
+				sketch_.ensure_capacity(sketch_size_);
+			}
+		}
+		sketch_.increment(hash_of(entry.key));
+		entry.segment = Segment::Window;
+		window_.push_most_recent(entry);
+
+		//while the main region has room the window overflows into it freely,
+		//once it is full pop_victim makes the window's oldest entry compete for a place
+		while (window_.weight() > window_capacity_
+			&& probation_.weight() + protected_.weight() + window_.least_recent()->weight <= main_capacity_)
+		{
+			TEntry& oldest = *window_.least_recent();
+			window_.unlink(oldest);
+			oldest.segment = Segment::Probation;
+			probation_.push_most_recent(oldest);
+		}
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void WTinyLfuPolicy<TEntry>::on_access(TEntry& entry)
+	{
+		sketch_.increment(hash_of(entry.key));
+		if (entry.segment != Segment::Probation)
+		{
+			list_for(entry).move_to_most_recent(entry);
+			return;
+		}
+
+		probation_.unlink(entry);
+		entry.segment = Segment::Protected;
+		protected_.push_most_recent(entry);
+		while (protected_.weight() > protected_capacity_)
+		{
+			TEntry& demoted = *protected_.least_recent();
+			protected_.unlink(demoted);
+			demoted.segment = Segment::Probation;
+			probation_.push_most_recent(demoted);
+		}
+	}
+
+	//O(1)
+	//misses count too, a key that keeps being asked for earns its place once it is put
+	template <typename TEntry>
+	template <typename TLookup>
+	void WTinyLfuPolicy<TEntry>::on_miss(const TLookup& key)
+	{
+		sketch_.increment(hash_of(key));
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void WTinyLfuPolicy<TEntry>::on_remove(TEntry& entry)
+	{
+		list_for(entry).unlink(entry);
+	}
+
+	//O(1) amortised
+	template <typename TEntry>
+	TEntry* WTinyLfuPolicy<TEntry>::pop_victim()
+	{
+		while (window_.weight() > window_capacity_)
+		{
+			TEntry* candidate = window_.least_recent();
+			window_.unlink(*candidate);
+			if (probation_.weight() + protected_.weight() + candidate->weight <= main_capacity_)
+			{
+				candidate->segment = Segment::Probation;
+				probation_.push_most_recent(*candidate);
+				continue;
+			}
+
+			TEntry* victim = main_victim();
+			if (victim == nullptr || frequency(*candidate) <= frequency(*victim))
+			{
+				return candidate; //not admitted
+			}
+			list_for(*victim).unlink(*victim);
+			candidate->segment = Segment::Probation;
+			probation_.push_most_recent(*candidate);
+			return victim;
+		}
+
+		TEntry* victim = main_victim();
+		list_for(*victim).unlink(*victim);
+		return victim;
+	}
+
+	//O(n)
+	//probation, then protected, then the window, each oldest first
+	//the segments and frequencies themselves aren't kept, so inserting in this order only approximates them
+	template <typename TEntry>
+	template <typename TVisit>
+	void WTinyLfuPolicy<TEntry>::for_each_coldest_first(TVisit visit) const
+	{
+		probation_.for_each_oldest_first(visit);
+		protected_.for_each_oldest_first(visit);
+		window_.for_each_oldest_first(visit);
+	}
+
+	//O(width of the sketch)
+	template <typename TEntry>
+	void WTinyLfuPolicy<TEntry>::clear()
+	{
+		window_.clear();
+		probation_.clear();
+		protected_.clear();
+		sketch_.clear();
+	}
+
+	/*** ClockPolicy ***/
+
+	//O(1) amortised
+	//appends entry at the tail, the buffer is regrown first if it is full
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::push(TEntry& entry)
+	{
+		if (tail_ - hand_ == ring_.size())
+		{
+			regrow();
+		}
+		ring_[tail_ & mask_] = &entry;
+		referenced_[tail_ & mask_] = 0;
+		entry.position = tail_++;
+	}
+
+	//O(n)
+	//copies the live entries in queue order into a buffer at least twice their number, dropping the holes,
+	//so at least half the new buffer is free and the copy is paid for by the pushes that fill it
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::regrow()
+	{
+		size_t live = 0;
+		for (size_t position = hand_; position != tail_; position++)
+		{
+			live += ring_[position & mask_] != nullptr ? 1 : 0;
+		}
+		size_t size = MIN_RING_SIZE;
+		while (size < live * 2)
+		{
+			size *= 2;
+		}
+
+		std::vector<TEntry*> ring(size, nullptr);
+		std::vector<uint8_t> referenced(size, 0);
+		size_t next = 0;
+		for (size_t position = hand_; position != tail_; position++)
+		{
+			TEntry* entry = ring_[position & mask_];
+			if (entry != nullptr)
+			{
+				ring[next] = entry;
+				referenced[next] = referenced_[position & mask_];
+				entry->position = next++;
+			}
+		}
+		ring_ = std::move(ring);
+		referenced_ = std::move(referenced);
+		mask_ = size - 1;
+		hand_ = 0;
+		tail_ = next;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::set_capacity(size_t, bool) {}
+
+	//O(1) amortised
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::on_insert(TEntry& entry)
+	{
+		push(entry);
+	}
+
+	//O(1)
+	//only writes when the bit isn't already set so repeated hits leave the cache line clean
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::on_access(TEntry& entry)
+	{
+		uint8_t& referenced = referenced_[entry.position & mask_];
+		if (referenced == 0)
+		{
+			referenced = 1;
+		}
+	}
+
+	//O(1)
+	template <typename TEntry>
+	template <typename TLookup>
+	void ClockPolicy<TEntry>::on_miss(const TLookup&) {}
+
+	//O(1)
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::on_remove(TEntry& entry)
+	{
+		ring_[entry.position & mask_] = nullptr;
+	}
+
+	//O(1) amortised, at most one full sweep
+	//a referenced entry has its bit cleared and goes back in at the tail, behind everything inserted before
+	//the hand reached it
+	template <typename TEntry>
+	TEntry* ClockPolicy<TEntry>::pop_victim()
+	{
+		while (true)
+		{
+			const size_t slot = hand_++ & mask_;
+			TEntry* entry = ring_[slot];
+			if (entry == nullptr)
+			{
+				continue;
+			}
+			ring_[slot] = nullptr;
+			if (referenced_[slot] == 0)
+			{
+				return entry;
+			}
+			push(*entry); //the hand just freed a slot, so this never regrows
+		}
+	}
+
+	//O(n)
+	//unreferenced entries from the hand round, then the referenced ones, which is the order pop_victim takes them
+	template <typename TEntry>
+	template <typename TVisit>
+	void ClockPolicy<TEntry>::for_each_coldest_first(TVisit visit) const
+	{
+		for (uint8_t referenced = 0; referenced <= 1; referenced++)
+		{
+			for (size_t position = hand_; position != tail_; position++)
+			{
+				const TEntry* entry = ring_[position & mask_];
+				if (entry != nullptr && referenced_[position & mask_] == referenced)
+				{
+					visit(*entry);
+				}
+			}
+		}
+	}
+
+	//O(n)
+	template <typename TEntry>
+	void ClockPolicy<TEntry>::clear()
+	{
+		std::fill(ring_.begin(), ring_.end(), nullptr);
+		hand_ = 0;
+		tail_ = 0;
+	}
+}
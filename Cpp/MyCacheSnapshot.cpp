@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "MyCacheSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ds
+{
+	namespace
+	{
+		const char SNAPSHOT_MAGIC[4] = { 'L', 'R', 'U', 'S' };
+		constexpr size_t STRING_READ_CHUNK = 64 * 1024;
+	}
+
+	//O(1)
+	void write_snapshot_header(std::ostream& out, uint64_t count)
+	{
+		out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+		write_snapshot_u64(out, SNAPSHOT_VERSION);
+		write_snapshot_u64(out, count);
+	}
+
+	//O(1)
+	//returns the entry count
+	uint64_t read_snapshot_header(std::istream& in)
+	{
+		char magic[sizeof(SNAPSHOT_MAGIC)] = {};
+		if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0)
+		{
+			throw std::exception("not a cache snapshot");
+		}
+		if (read_snapshot_u64(in) != SNAPSHOT_VERSION)
+		{
+			throw std::exception("unsupported snapshot version");
+		}
+		return read_snapshot_u64(in);
+	}
+
+	//O(1)
+	//byte by byte so the framing reads the same on any endianness
+	void write_snapshot_u64(std::ostream& out, uint64_t value)
+	{
+		char bytes[sizeof(uint64_t)];
+		for (size_t byte = 0; byte < sizeof(bytes); byte++)
+		{
+			bytes[byte] = static_cast<char>(value >> (8 * byte));
+		}
+		out.write(bytes, sizeof(bytes));
+	}
+
+	//O(1)
+	uint64_t read_snapshot_u64(std::istream& in)
+	{
+		unsigned char bytes[sizeof(uint64_t)];
+		if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+		{
+			throw std::exception("snapshot truncated");
+		}
+		uint64_t value = 0;
+		for (size_t byte = sizeof(bytes); byte > 0; byte--)
+		{
+			value = (value << 8) | bytes[byte - 1];
+		}
+		return value;
+	}
+
+	//appends to bytes, which the caller clears between records
+	ByteSink::ByteSink(std::vector<char>& bytes) : bytes_(bytes) {}
+
+	//O(1) amortised
+	ByteSink::int_type ByteSink::overflow(int_type character)
+	{
+		if (!traits_type::eq_int_type(character, traits_type::eof()))
+		{
+			bytes_.push_back(traits_type::to_char_type(character));
+		}
+		return traits_type::not_eof(character);
+	}
+
+	//O(count) amortised
+	std::streamsize ByteSink::xsputn(const char* data, std::streamsize count)
+	{
+		bytes_.insert(bytes_.end(), data, data + count);
+		return count;
+	}
+
+	//the memory is only read, streambuf just has no const get area
+	ByteSource::ByteSource(const char* data, size_t size)
+	{
+		char* begin = const_cast<char*>(data);
+		setg(begin, begin, begin + size);
+	}
+
+	//O(length)
+	void SnapshotSerializer<std::string>::write(std::ostream& out, const std::string& value)
+	{
+		write_snapshot_u64(out, value.size());
+		out.write(value.data(), static_cast<std::streamsize>(value.size()));
+	}
+
+	//O(length)
+	//the length is only trusted as far as the bytes behind it, the string grows a chunk at a time as they are read,
+	//so a corrupt or cut off length ends in "snapshot truncated" rather than one huge allocation
+	std::string SnapshotSerializer<std::string>::read(std::istream& in)
+	{
+		uint64_t remaining = read_snapshot_u64(in);
+		std::string value;
+		while (remaining > 0)
+		{
+			const size_t chunk = static_cast<size_t>(std::min<uint64_t>(remaining, STRING_READ_CHUNK));
+			const size_t read_so_far = value.size();
+			value.resize(read_so_far + chunk);
+			if (!in.read(value.data() + read_so_far, static_cast<std::streamsize>(chunk)))
+			{
+				throw std::exception("snapshot truncated");
+			}
+			remaining -= chunk;
+		}
+		return value;
+	}
+}
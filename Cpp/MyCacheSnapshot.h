@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ds
+{
+	//a snapshot is a header followed by one record per entry, coldest entry first
+	//
+	//	header	"LRUS", format version, entry count, all little endian
+	//	record	key, value, time to live and time left in milliseconds (0 for entries that never expire)
+	//
+	//keys and values are written by serializers, a serializer for T has
+	//	static void write(std::ostream& out, const T& value)
+	//	static T read(std::istream& in)
+	//SnapshotSerializer covers trivially copyable types and std::string, anything else needs its own
+	constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	void write_snapshot_header(std::ostream& out, uint64_t count);
+	uint64_t read_snapshot_header(std::istream& in);
+	void write_snapshot_u64(std::ostream& out, uint64_t value);
+	uint64_t read_snapshot_u64(std::istream& in);
+
+	template<typename T, typename = void>
+	struct SnapshotSerializer;
+
+	//stream buffers over plain memory, so a serializer can fill a reusable byte vector or read a record in place
+	class ByteSink : public std::streambuf
+	{
+		std::vector<char>& bytes_;
+
+	public:
+		explicit ByteSink(std::vector<char>& bytes);
+
+	protected:
+		int_type overflow(int_type character) override;
+		std::streamsize xsputn(const char* data, std::streamsize count) override;
+	};
+
+	class ByteSource : public std::streambuf
+	{
+	public:
+		ByteSource(const char* data, size_t size);
+	};
+
+	//raw bytes, so the snapshot is only readable on a machine with the same layout for T
+	template<typename T>
+	struct SnapshotSerializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+	{
+		static void write(std::ostream& out, const T& value);
+		static T read(std::istream& in);
+	};
+
+	//length then characters
+	template<>
+	struct SnapshotSerializer<std::string>
+	{
+		static void write(std::ostream& out, const std::string& value);
+		static std::string read(std::istream& in);
+	};
+
+	//O(1)
+	template <typename T>
+	void SnapshotSerializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>::write(std::ostream& out, const T& value)
+	{
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	//O(1)
+	template <typename T>
+	T SnapshotSerializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>::read(std::istream& in)
+	{
+		T value;
+		if (!in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+		{
+			throw std::exception("snapshot truncated");
+		}
+		return value;
+	}
+}
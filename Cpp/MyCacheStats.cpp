@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "MyCacheStats.h"
+
+namespace ds
+{
+	//O(1)
+	//0 before the first lookup
+	double CacheStatsSnapshot::hit_ratio() const
+	{
+		const uint64_t lookups = hits + misses;
+		return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+	}
+
+	//O(1)
+	double CacheStatsSnapshot::average_load_nanoseconds() const
+	{
+		const uint64_t loads = load_successes + load_failures;
+		return loads == 0 ? 0.0 : static_cast<double>(total_load_nanoseconds) / static_cast<double>(loads);
+	}
+
+	//O(1)
+	//lets a sharded cache add its shards up
+	CacheStatsSnapshot& CacheStatsSnapshot::operator+=(const CacheStatsSnapshot& other)
+	{
+		hits += other.hits;
+		misses += other.misses;
+		puts += other.puts;
+		removals += other.removals;
+		capacity_evictions += other.capacity_evictions;
+		expired_evictions += other.expired_evictions;
+		load_successes += other.load_successes;
+		load_failures += other.load_failures;
+		total_load_nanoseconds += other.total_load_nanoseconds;
+		weight += other.weight;
+		return *this;
+	}
+
+	//O(1)
+	CacheStatsSnapshot CacheStats::snapshot() const
+	{
+		CacheStatsSnapshot result;
+		result.hits = hits_.load(std::memory_order_relaxed);
+		result.misses = misses_.load(std::memory_order_relaxed);
+		result.puts = puts_.load(std::memory_order_relaxed);
+		result.removals = removals_.load(std::memory_order_relaxed);
+		result.capacity_evictions = capacity_evictions_.load(std::memory_order_relaxed);
+		result.expired_evictions = expired_evictions_.load(std::memory_order_relaxed);
+		result.load_successes = load_successes_.load(std::memory_order_relaxed);
+		result.load_failures = load_failures_.load(std::memory_order_relaxed);
+		result.total_load_nanoseconds = total_load_nanoseconds_.load(std::memory_order_relaxed);
+		result.weight = weight_.load(std::memory_order_relaxed);
+		return result;
+	}
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ds
+{
+	enum class RemovalCause : uint8_t { Capacity, Expired, Explicit, Replaced };
+
+	//point in time copy of a cache's counters
+	struct CacheStatsSnapshot
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t puts = 0;
+		uint64_t removals = 0; //explicit removes
+		uint64_t capacity_evictions = 0;
+		uint64_t expired_evictions = 0;
+		uint64_t load_successes = 0;
+		uint64_t load_failures = 0;
+		uint64_t total_load_nanoseconds = 0;
+		uint64_t weight = 0;
+
+		[[nodiscard]] double hit_ratio() const;
+		[[nodiscard]] double average_load_nanoseconds() const;
+		CacheStatsSnapshot& operator+=(const CacheStatsSnapshot& other);
+	};
+
+	//statistics recorders are the last template argument of MyLruCache and MyConcurrentLruCache
+	//NoCacheStats is the default, its calls are empty and ENABLED lets the cache skip the clock
+	//reads around loads, so a cache built without statistics compiles down to what it was before
+	class NoCacheStats
+	{
+	public:
+		static constexpr bool ENABLED = false;
+
+		void record_hit() {}
+		void record_miss() {}
+		void record_put() {}
+		void record_removal() {}
+		void record_eviction(RemovalCause) {}
+		void record_load(bool, uint64_t) {}
+		void record_weight(size_t) {}
+		[[nodiscard]] CacheStatsSnapshot snapshot() const { return {}; }
+	};
+
+	//counts with relaxed atomics so a snapshot can be taken from any thread while the cache is in use,
+	//the counters are read one by one so a snapshot under traffic can be off by the odd in flight call
+	class CacheStats
+	{
+		std::atomic<uint64_t> hits_ = 0;
+		std::atomic<uint64_t> misses_ = 0;
+		std::atomic<uint64_t> puts_ = 0;
+		std::atomic<uint64_t> removals_ = 0;
+		std::atomic<uint64_t> capacity_evictions_ = 0;
+		std::atomic<uint64_t> expired_evictions_ = 0;
+		std::atomic<uint64_t> load_successes_ = 0;
+		std::atomic<uint64_t> load_failures_ = 0;
+		std::atomic<uint64_t> total_load_nanoseconds_ = 0;
+		std::atomic<uint64_t> weight_ = 0;
+
+		static void bump(std::atomic<uint64_t>& counter);
+
+	public:
+		static constexpr bool ENABLED = true;
+
+		void record_hit();
+		void record_miss();
+		void record_put();
+		void record_removal();
+		void record_eviction(RemovalCause cause);
+		void record_load(bool succeeded, uint64_t nanoseconds);
+		void record_weight(size_t weight);
+		[[nodiscard]] CacheStatsSnapshot snapshot() const;
+	};
+
+	//O(1)
+	//relaxed since the counters don't order anything else, hits can be recorded under a shared lock
+	inline void CacheStats::bump(std::atomic<uint64_t>& counter)
+	{
+		counter.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//O(1)
+	inline void CacheStats::record_hit()
+	{
+		bump(hits_);
+	}
+
+	//O(1)
+	inline void CacheStats::record_miss()
+	{
+		bump(misses_);
+	}
+
+	//O(1)
+	inline void CacheStats::record_put()
+	{
+		bump(puts_);
+	}
+
+	//O(1)
+	inline void CacheStats::record_removal()
+	{
+		bump(removals_);
+	}
+
+	//O(1)
+	inline void CacheStats::record_eviction(RemovalCause cause)
+	{
+		bump(cause == RemovalCause::Expired ? expired_evictions_ : capacity_evictions_);
+	}
+
+	//O(1)
+	inline void CacheStats::record_load(bool succeeded, uint64_t nanoseconds)
+	{
+		bump(succeeded ? load_successes_ : load_failures_);
+		total_load_nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+	}
+
+	//O(1)
+	inline void CacheStats::record_weight(size_t weight)
+	{
+		weight_.store(weight, std::memory_order_relaxed);
+	}
+
+	//O(1)
+	//the clock is only read when TStats records anything
+	template<typename TStats>
+	std::chrono::steady_clock::time_point start_load_timer()
+	{
+		if constexpr (TStats::ENABLED)
+		{
+			return std::chrono::steady_clock::now();
+		}
+		else
+		{
+			return {};
+		}
+	}
+
+	//O(1)
+	template<typename TStats>
+	uint64_t nanoseconds_since(std::chrono::steady_clock::time_point started)
+	{
+		if constexpr (TStats::ENABLED)
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+		}
+		else
+		{
+			return 0;
+		}
+	}
+}
@@ -0,0 +1,786 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "MyLruCache.h"
+
+namespace ds
+{
+	constexpr size_t READ_BUFFER_SIZE = 32;
+	constexpr size_t READ_BUFFER_STRIPES = 4;
+
+	//splits the keyspace over independently locked MyLruCache shards so threads only contend
+	//when they touch the same shard, each shard gets an equal slice of the total capacity
+	//
+	//with a drain threshold set, hits only take the shard's lock shared and record the key into a
+	//small lossy buffer picked by thread, the recency updates are replayed in batches by whichever
+	//thread fills a buffer and can take the lock exclusively, or by the next write (BP-Wrapper)
+	//
+	//get_or_load coalesces concurrent misses on a key, one caller runs the loader while the rest wait on its result
+	//
+	//get, try_get and contains take a key-like type the same way MyLruCache's reads do, though a buffered hit
+	//still copies the key into the read buffer
+	//
+	//removals are queued inside the shard and the removal listener runs after the shard's lock is released,
+	//so a slow listener holds up the thread whose call removed the entries but never the shard's other callers
+	template<typename TKey, typename TValue, template<typename> class TPolicy = LruPolicy, typename TStats = NoCacheStats>
+	class MyConcurrentLruCache
+	{
+		struct alignas(64) ReadBuffer
+		{
+			std::atomic_flag busy = ATOMIC_FLAG_INIT;
+			size_t count = 0;
+			std::array<TKey, READ_BUFFER_SIZE> keys;
+		};
+
+		struct Load
+		{
+			std::promise<TValue> promise;
+			std::shared_future<TValue> result = promise.get_future().share();
+			bool superseded = false; //a put, remove or clear for the key happened while loading
+		};
+
+		struct alignas(64) Shard //one cache line per lock so neighbouring shards don't false share
+		{
+			std::shared_mutex mutex;
+			MyLruCache<TKey, TValue, TPolicy, TStats> cache;
+			std::array<ReadBuffer, READ_BUFFER_STRIPES> read_buffers;
+			TStats stats; //lookups answered under the shared lock and loads, the cache counts the rest
+			std::unordered_map<TKey, std::shared_ptr<Load>> loads; //keys with a loader running
+		};
+
+		using Cache = MyLruCache<TKey, TValue, TPolicy, TStats>;
+
+		//exclusive lock on a shard, whatever its cache queued for the removal listener is taken while locked
+		//and delivered once the lock is released
+		class WriteLock
+		{
+			Shard& shard_;
+			std::unique_lock<std::shared_mutex> lock_;
+
+		public:
+			explicit WriteLock(Shard& shard) : shard_(shard), lock_(shard.mutex) {}
+			WriteLock(const WriteLock&) = delete;
+			WriteLock& operator=(const WriteLock&) = delete;
+			~WriteLock()
+			{
+				std::vector<typename Cache::Removal> removals = shard_.cache.take_removals();
+				lock_.unlock();
+				if (!removals.empty())
+				{
+					shard_.cache.notify_removals(removals);
+				}
+			}
+		};
+
+		std::vector<Shard> shards_;
+		size_t capacity_ = DEFAULT_CAPACITY;
+		int shard_shift_;
+		std::atomic<size_t> drain_threshold_ = 0;
+
+		template<typename TLookup>
+		Shard& shard_for(const TLookup& key);
+		template<typename TLookup>
+		size_t shard_index(const TLookup& key) const;
+		void group_by_shard(const std::vector<TKey>& keys, std::vector<size_t>& out_order, std::vector<size_t>& out_starts) const;
+		static size_t round_up_to_power_of_two(size_t value);
+		static size_t read_buffer_stripe();
+		void record_read(Shard& shard, const TKey& key);
+		static void drain_read_buffers(Shard& shard);
+		static void supersede_load(Shard& shard, const TKey& key);
+		template<typename TLookup>
+		std::optional<TValue> copy_value(const TLookup& key);
+
+	public:
+		explicit MyConcurrentLruCache(size_t shard_count = std::thread::hardware_concurrency());
+
+		size_t size();
+		size_t get_weight();
+		size_t get_capacity() const;
+		void set_capacity(size_t capacity);
+		void set_weigher(std::function<size_t(const TKey&, const TValue&)> weigher);
+		size_t get_shard_count() const;
+		size_t get_drain_threshold() const;
+		void set_drain_threshold(size_t threshold);
+
+		void set_refresh_on_get(bool refresh);
+		void set_time_source(std::function<uint64_t()> time_source);
+		void set_removal_listener(typename Cache::RemovalListener listener);
+
+		void put(const TKey& key, TValue& value);
+		void put(const TKey& key, TValue&& value);
+		void put(TKey&& key, TValue&& value);
+		template<typename TKeyArg, typename... TArgs>
+		void emplace(TKeyArg&& key, TArgs&&... value_args);
+		void put(const TKey& key, TValue& value, std::chrono::milliseconds time_to_live);
+		void put_many(const std::vector<TKey>& keys, std::vector<TValue>& values);
+		template<typename TLookup = TKey>
+		TValue get(const TLookup& key);
+		template<typename TLookup = TKey>
+		bool try_get(const TLookup& key, TValue& out_value);
+		size_t get_many(const std::vector<TKey>& keys, std::vector<TValue>& out_values, std::vector<bool>& out_found);
+		template<typename TLoader>
+		TValue get_or_load(const TKey& key, TLoader loader);
+		void remove(const TKey& key);
+		template<typename TLookup = TKey>
+		bool contains(const TLookup& key);
+		size_t remove_expired();
+		void clear();
+		bool is_empty();
+		CacheStatsSnapshot get_stats();
+	};
+
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::MyConcurrentLruCache(size_t shard_count)
+		: shards_(round_up_to_power_of_two(shard_count))
+	{
+		shard_shift_ = 64;
+		for (size_t count = shards_.size(); count > 1; count >>= 1)
+		{
+			--shard_shift_;
+		}
+		set_capacity(capacity_);
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	typename MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::Shard& MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::shard_for(const TLookup& key)
+	{
+		return shards_[shard_index(key)];
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::shard_index(const TLookup& key) const
+	{
+		if (shards_.size() == 1)
+		{
+			return 0;
+		}
+		//fibonacci hashing, takes the top bits so the shard doesn't correlate with the bucket the shard's own map picks
+		const uint64_t hash = static_cast<uint64_t>(LookupHash<TKey>{}(key)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(hash >> shard_shift_);
+	}
+
+	//O(keys + shards)
+	//counting sort of the key indices by shard, shard s owns out_order[out_starts[s]] up to out_order[out_starts[s + 1]]
+	//keys keep their relative order within a shard so repeated keys in a batch apply in order
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::group_by_shard(const std::vector<TKey>& keys, std::vector<size_t>& out_order, std::vector<size_t>& out_starts) const
+	{
+		std::vector<size_t> shard_of(keys.size());
+		out_starts.assign(shards_.size() + 1, 0);
+		for (size_t index = 0; index < keys.size(); index++)
+		{
+			shard_of[index] = shard_index(keys[index]);
+			++out_starts[shard_of[index] + 1];
+		}
+		for (size_t shard = 0; shard < shards_.size(); shard++)
+		{
+			out_starts[shard + 1] += out_starts[shard];
+		}
+		std::vector<size_t> next(out_starts.begin(), out_starts.end() - 1);
+		out_order.resize(keys.size());
+		for (size_t index = 0; index < keys.size(); index++)
+		{
+			out_order[next[shard_of[index]]++] = index;
+		}
+	}
+
+	//O(log n)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::round_up_to_power_of_two(size_t value)
+	{
+		size_t result = 1;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::read_buffer_stripe()
+	{
+		static thread_local const size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % READ_BUFFER_STRIPES;
+		return stripe;
+	}
+
+	//O(1) amortised
+	//never waits, if the buffer is being used by another thread or is full the read is just dropped,
+	//losing the odd recency update only makes the lru slightly less exact
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::record_read(Shard& shard, const TKey& key)
+	{
+		ReadBuffer& buffer = shard.read_buffers[read_buffer_stripe()];
+		if (buffer.busy.test_and_set(std::memory_order_acquire))
+		{
+			return;
+		}
+		if (buffer.count < READ_BUFFER_SIZE)
+		{
+			buffer.keys[buffer.count++] = key;
+		}
+		const bool should_drain = buffer.count >= drain_threshold_.load(std::memory_order_relaxed);
+		buffer.busy.clear(std::memory_order_release);
+
+		if (should_drain)
+		{
+			//not a WriteLock, a replayed read that finds its entry expired leaves the removal for the shard's next write
+			std::unique_lock lock(shard.mutex, std::try_to_lock);
+			if (lock.owns_lock())
+			{
+				drain_read_buffers(shard);
+			}
+		}
+	}
+
+	//O(buffered reads)
+	//caller must hold the shard's lock exclusively
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::drain_read_buffers(Shard& shard)
+	{
+		for (ReadBuffer& buffer : shard.read_buffers)
+		{
+			if (buffer.busy.test_and_set(std::memory_order_acquire))
+			{
+				continue; //a reader is mid record, it will be picked up next drain
+			}
+			for (size_t index = 0; index < buffer.count; index++)
+			{
+				shard.cache.touch(buffer.keys[index]);
+			}
+			buffer.count = 0;
+			buffer.busy.clear(std::memory_order_release);
+		}
+	}
+
+	//O(1)
+	//caller must hold the shard's lock exclusively
+	//stops a load that is still running from overwriting a newer write once it finishes
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::supersede_load(Shard& shard, const TKey& key)
+	{
+		if (shard.loads.empty())
+		{
+			return;
+		}
+		auto got = shard.loads.find(key);
+		if (got != shard.loads.end())
+		{
+			got->second->superseded = true;
+		}
+	}
+
+	//O(shards)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::size()
+	{
+		size_t total = 0;
+		for (Shard& shard : shards_)
+		{
+			std::shared_lock lock(shard.mutex);
+			total += shard.cache.size();
+		}
+		return total;
+	}
+
+	//O(shards)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_weight()
+	{
+		size_t total = 0;
+		for (Shard& shard : shards_)
+		{
+			std::shared_lock lock(shard.mutex);
+			total += shard.cache.get_weight();
+		}
+		return total;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_capacity() const
+	{
+		return capacity_;
+	}
+
+	//O(n) worse case
+	//O(shards) best case
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::set_capacity(size_t capacity)
+	{
+		capacity_ = capacity;
+		const size_t per_shard = capacity / shards_.size();
+		const size_t remainder = capacity % shards_.size();
+		for (size_t index = 0; index < shards_.size(); index++)
+		{
+			WriteLock lock(shards_[index]);
+			drain_read_buffers(shards_[index]);
+			shards_[index].cache.set_capacity(per_shard + (index < remainder ? 1 : 0));
+		}
+	}
+
+	//O(shards)
+	//each shard gets an even slice of the budget, so an entry heavier than a slice is refused
+	//weigher is shared by every shard so it has to be safe to call from several threads
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::set_weigher(std::function<size_t(const TKey&, const TValue&)> weigher)
+	{
+		for (Shard& shard : shards_)
+		{
+			std::unique_lock lock(shard.mutex);
+			shard.cache.set_weigher(weigher);
+		}
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_shard_count() const
+	{
+		return shards_.size();
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_drain_threshold() const
+	{
+		return drain_threshold_.load(std::memory_order_relaxed);
+	}
+
+	//O(1)
+	//0 turns buffering off so every hit reorders the lru under an exclusive lock,
+	//otherwise a thread's buffered reads are applied once it has recorded threshold of them
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::set_drain_threshold(size_t threshold)
+	{
+		if (threshold > READ_BUFFER_SIZE)
+		{
+			throw std::exception("drain threshold larger than read buffer");
+		}
+		drain_threshold_.store(threshold, std::memory_order_relaxed);
+	}
+
+	//O(shards)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::set_refresh_on_get(bool refresh)
+	{
+		for (Shard& shard : shards_)
+		{
+			std::unique_lock lock(shard.mutex);
+			shard.cache.set_refresh_on_get(refresh);
+		}
+	}
+
+	//O(shards)
+	//time_source is shared by every shard so it has to be safe to call from several threads
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::set_time_source(std::function<uint64_t()> time_source)
+	{
+		for (Shard& shard : shards_)
+		{
+			std::unique_lock lock(shard.mutex);
+			shard.cache.set_time_source(time_source);
+		}
+	}
+
+	//O(shards)
+	//see MyLruCache::set_removal_listener, listener is shared by every shard so it has to be safe to call from
+	//several threads, and it is read without the shard locks so it should be set before the cache is shared
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::set_removal_listener(typename Cache::RemovalListener listener)
+	{
+		for (Shard& shard : shards_)
+		{
+			WriteLock lock(shard);
+			shard.cache.set_hold_removals(true);
+			shard.cache.set_removal_listener(listener);
+		}
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::put(const TKey& key, TValue& value)
+	{
+		Shard& shard = shard_for(key);
+		WriteLock lock(shard);
+		drain_read_buffers(shard); //so eviction sees the reads made so far
+		supersede_load(shard, key);
+		shard.cache.put(key, value);
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::put(const TKey& key, TValue&& value)
+	{
+		Shard& shard = shard_for(key);
+		WriteLock lock(shard);
+		drain_read_buffers(shard);
+		supersede_load(shard, key);
+		shard.cache.put(key, std::move(value));
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::put(TKey&& key, TValue&& value)
+	{
+		Shard& shard = shard_for(key);
+		WriteLock lock(shard);
+		drain_read_buffers(shard);
+		supersede_load(shard, key);
+		shard.cache.put(std::move(key), std::move(value));
+	}
+
+	//O(1) amortised
+	//the value is built in place inside the shard, see MyLruCache::emplace
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeyArg, typename... TArgs>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::emplace(TKeyArg&& key, TArgs&&... value_args)
+	{
+		Shard& shard = shard_for(key);
+		WriteLock lock(shard);
+		drain_read_buffers(shard);
+		supersede_load(shard, key);
+		shard.cache.emplace(std::forward<TKeyArg>(key), std::forward<TArgs>(value_args)...);
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::put(const TKey& key, TValue& value, std::chrono::milliseconds time_to_live)
+	{
+		Shard& shard = shard_for(key);
+		WriteLock lock(shard);
+		drain_read_buffers(shard);
+		supersede_load(shard, key);
+		shard.cache.put(key, value, time_to_live);
+	}
+
+	//O(keys + shards) amortised
+	//takes each shard's lock once for all of that shard's keys instead of once per key
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::put_many(const std::vector<TKey>& keys, std::vector<TValue>& values)
+	{
+		if (keys.size() != values.size())
+		{
+			throw std::exception("keys and values differ in length");
+		}
+		std::vector<size_t> order;
+		std::vector<size_t> starts;
+		group_by_shard(keys, order, starts);
+		for (size_t shard_number = 0; shard_number < shards_.size(); shard_number++)
+		{
+			if (starts[shard_number] == starts[shard_number + 1])
+			{
+				continue;
+			}
+			Shard& shard = shards_[shard_number];
+			WriteLock lock(shard);
+			drain_read_buffers(shard);
+			for (size_t position = starts[shard_number]; position < starts[shard_number + 1]; position++)
+			{
+				const size_t index = order[position];
+				supersede_load(shard, keys[index]);
+				shard.cache.put(keys[index], values[index]);
+			}
+		}
+	}
+
+	//O(1)
+	//returns a copy, a reference into the shard would dangle once the lock is released
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	TValue MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get(const TLookup& key)
+	{
+		std::optional<TValue> value = copy_value(key);
+		if (!value)
+		{
+			throw std::exception("key not in lru");
+		}
+		return std::move(*value);
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	bool MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::try_get(const TLookup& key, TValue& out_value)
+	{
+		std::optional<TValue> value = copy_value(key);
+		if (!value)
+		{
+			return false;
+		}
+		out_value = std::move(*value);
+		return true;
+	}
+
+	//O(1) amortised
+	//the value is copy constructed straight into the optional, so TValue needn't be default constructible
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	std::optional<TValue> MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::copy_value(const TLookup& key)
+	{
+		Shard& shard = shard_for(key);
+		if (drain_threshold_.load(std::memory_order_relaxed) == 0)
+		{
+			WriteLock lock(shard);
+			TValue* value = shard.cache.try_get(key);
+			if (value == nullptr)
+			{
+				return std::nullopt;
+			}
+			return std::optional<TValue>(*value);
+		}
+
+		std::optional<TValue> copy;
+		{
+			std::shared_lock lock(shard.mutex);
+			const TValue* value = shard.cache.peek(key);
+			if (value == nullptr)
+			{
+				shard.stats.record_miss();
+				return std::nullopt;
+			}
+			copy.emplace(*value);
+		}
+		shard.stats.record_hit();
+		if constexpr (std::is_same_v<TLookup, TKey>)
+		{
+			record_read(shard, key);
+		}
+		else
+		{
+			record_read(shard, TKey(key));
+		}
+		return copy;
+	}
+
+	//O(keys + shards) amortised
+	//out_values[i] and out_found[i] are what try_get(keys[i]) would give, returns the number of hits
+	//each shard's lock is taken once for all of that shard's keys instead of once per key
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_many(const std::vector<TKey>& keys, std::vector<TValue>& out_values, std::vector<bool>& out_found)
+	{
+		out_values.resize(keys.size());
+		out_found.assign(keys.size(), false);
+		std::vector<size_t> order;
+		std::vector<size_t> starts;
+		group_by_shard(keys, order, starts);
+
+		const bool buffered = drain_threshold_.load(std::memory_order_relaxed) != 0;
+		size_t hits = 0;
+		for (size_t shard_number = 0; shard_number < shards_.size(); shard_number++)
+		{
+			const size_t first = starts[shard_number];
+			const size_t last = starts[shard_number + 1];
+			if (first == last)
+			{
+				continue;
+			}
+			Shard& shard = shards_[shard_number];
+			if (!buffered)
+			{
+				WriteLock lock(shard);
+				for (size_t position = first; position < last; position++)
+				{
+					const size_t index = order[position];
+					TValue* value = shard.cache.try_get(keys[index]);
+					if (value != nullptr)
+					{
+						out_values[index] = *value;
+						out_found[index] = true;
+						++hits;
+					}
+				}
+				continue;
+			}
+
+			{
+				std::shared_lock lock(shard.mutex);
+				for (size_t position = first; position < last; position++)
+				{
+					const size_t index = order[position];
+					const TValue* value = shard.cache.peek(keys[index]);
+					if (value == nullptr)
+					{
+						shard.stats.record_miss();
+						continue;
+					}
+					shard.stats.record_hit();
+					out_values[index] = *value;
+					out_found[index] = true;
+					++hits;
+				}
+			}
+			for (size_t position = first; position < last; position++)
+			{
+				if (out_found[order[position]])
+				{
+					record_read(shard, keys[order[position]]);
+				}
+			}
+		}
+		return hits;
+	}
+
+	//O(1) amortised plus one loader call per coalesced miss
+	//the loader runs without the shard's lock held so other keys in the shard aren't held up
+	//if it throws, every caller waiting on it gets the exception and nothing is cached,
+	//the next get_or_load for the key tries again
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLoader>
+	TValue MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_or_load(const TKey& key, TLoader loader)
+	{
+		std::optional<TValue> cached = copy_value(key);
+		if (cached)
+		{
+			return std::move(*cached);
+		}
+
+		Shard& shard = shard_for(key);
+		std::shared_ptr<Load> load;
+		{
+			std::unique_lock lock(shard.mutex);
+			drain_read_buffers(shard); //not a WriteLock, the same as record_read's drain
+			const TValue* value = shard.cache.peek(key); //loaded while we weren't holding the lock
+			if (value != nullptr)
+			{
+				//a hit like get's, the lock is already held exclusively so the read is applied rather than buffered
+				shard.cache.touch(key);
+				shard.stats.record_hit();
+				return *value;
+			}
+			auto [got, inserted] = shard.loads.try_emplace(key);
+			if (!inserted)
+			{
+				std::shared_future<TValue> pending = got->second->result;
+				lock.unlock();
+				return pending.get();
+			}
+			got->second = std::make_shared<Load>();
+			load = got->second;
+		}
+
+		const std::chrono::steady_clock::time_point started = start_load_timer<TStats>();
+		std::optional<TValue> result;
+		bool loaded = false;
+		try
+		{
+			result.emplace(loader(key));
+			loaded = true;
+			shard.stats.record_load(true, nanoseconds_since<TStats>(started));
+			WriteLock lock(shard);
+			shard.loads.erase(key);
+			if (!load->superseded)
+			{
+				drain_read_buffers(shard);
+				shard.cache.put(key, *result);
+			}
+		}
+		catch (...)
+		{
+			if (!loaded)
+			{
+				shard.stats.record_load(false, nanoseconds_since<TStats>(started));
+			}
+			{
+				std::unique_lock lock(shard.mutex);
+				auto got = shard.loads.find(key);
+				if (got != shard.loads.end() && got->second == load)
+				{
+					shard.loads.erase(got);
+				}
+			}
+			load->promise.set_exception(std::current_exception());
+			throw;
+		}
+		load->promise.set_value(*result);
+		return std::move(*result);
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::remove(const TKey& key)
+	{
+		Shard& shard = shard_for(key);
+		WriteLock lock(shard);
+		drain_read_buffers(shard);
+		supersede_load(shard, key);
+		shard.cache.remove(key);
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	bool MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::contains(const TLookup& key)
+	{
+		Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return shard.cache.peek(key) != nullptr;
+	}
+
+	//O(shards + expired) amortised
+	//locks one shard at a time, so a background sweep only ever stalls that shard's callers
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::remove_expired()
+	{
+		size_t removed = 0;
+		for (Shard& shard : shards_)
+		{
+			WriteLock lock(shard);
+			drain_read_buffers(shard);
+			removed += shard.cache.remove_expired();
+		}
+		return removed;
+	}
+
+	//O(n)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::clear()
+	{
+		for (Shard& shard : shards_)
+		{
+			WriteLock lock(shard);
+			drain_read_buffers(shard);
+			for (auto& [key, load] : shard.loads)
+			{
+				load->superseded = true;
+			}
+			shard.cache.clear();
+		}
+	}
+
+	//O(shards)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	bool MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::is_empty()
+	{
+		return size() == 0;
+	}
+
+	//O(shards)
+	//adds up every shard's counters without taking any locks
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	CacheStatsSnapshot MyConcurrentLruCache<TKey, TValue, TPolicy, TStats>::get_stats()
+	{
+		CacheStatsSnapshot total;
+		for (Shard& shard : shards_)
+		{
+			total += shard.cache.get_stats();
+			total += shard.stats.snapshot();
+		}
+		return total;
+	}
+}
@@ -0,0 +1,124 @@
+#include "pch.h"
+#include "MyCountMinSketch.h"
+
+#include <algorithm>
+
+namespace ds
+{
+	constexpr uint64_t ROW_SEEDS[] = { 0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full, 0xcbf29ce484222325ull };
+	constexpr int ROWS = 4;
+	constexpr int MAX_COUNT = 15;
+	constexpr uint64_t RESET_MASK = 0x7777777777777777ull;
+
+	//O(width) when growing
+	//O(1) otherwise
+	void MyCountMinSketch::ensure_capacity(size_t maximum_size)
+	{
+		size_t width = 1;
+		while (width < maximum_size)
+		{
+			width <<= 1;
+		}
+		if (width <= table_.size())
+		{
+			return;
+		}
+		table_.assign(width, 0);
+		table_mask_ = width - 1;
+		sample_size_ = std::max<size_t>(10, 10 * maximum_size);
+		additions_ = 0;
+	}
+
+	//O(1)
+	int MyCountMinSketch::frequency(uint64_t hash) const
+	{
+		if (table_.empty())
+		{
+			return 0;
+		}
+		hash = spread(hash);
+		const int start = static_cast<int>(hash & 3) << 2;
+		int result = MAX_COUNT;
+		for (int row = 0; row < ROWS; row++)
+		{
+			const int shift = (start + row) << 2;
+			const int count = static_cast<int>((table_[index_of(hash, row)] >> shift) & 0xF);
+			result = std::min(result, count);
+		}
+		return result;
+	}
+
+	//O(1) amortised, O(width) when the counters are aged
+	void MyCountMinSketch::increment(uint64_t hash)
+	{
+		if (table_.empty())
+		{
+			return;
+		}
+		hash = spread(hash);
+		const int start = static_cast<int>(hash & 3) << 2;
+		bool added = false;
+		for (int row = 0; row < ROWS; row++)
+		{
+			added |= increment_at(index_of(hash, row), start + row);
+		}
+		if (added && ++additions_ >= sample_size_)
+		{
+			age();
+		}
+	}
+
+	//O(width)
+	void MyCountMinSketch::clear()
+	{
+		std::fill(table_.begin(), table_.end(), 0);
+		additions_ = 0;
+	}
+
+	//O(1)
+	size_t MyCountMinSketch::get_sample_size() const
+	{
+		return sample_size_;
+	}
+
+	//O(width)
+	void MyCountMinSketch::age()
+	{
+		for (uint64_t& word : table_)
+		{
+			word = (word >> 1) & RESET_MASK;
+		}
+		additions_ /= 2;
+	}
+
+	//O(1)
+	bool MyCountMinSketch::increment_at(size_t index, int counter)
+	{
+		const int shift = counter << 2;
+		const uint64_t mask = 0xFull << shift;
+		if ((table_[index] & mask) == mask)
+		{
+			return false;
+		}
+		table_[index] += 1ull << shift;
+		return true;
+	}
+
+	//O(1)
+	size_t MyCountMinSketch::index_of(uint64_t hash, int row) const
+	{
+		uint64_t h = (hash + ROW_SEEDS[row]) * ROW_SEEDS[row];
+		h += h >> 32;
+		return static_cast<size_t>(h) & table_mask_;
+	}
+
+	//O(1)
+	//std::hash is the identity for integers on common standard libraries, so mix before using the bits
+	uint64_t MyCountMinSketch::spread(uint64_t hash)
+	{
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+}
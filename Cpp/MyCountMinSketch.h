@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace ds
+{
+	//approximate frequency counter in fixed memory, each key maps to one 4 bit counter in each of
+	//four rows and its frequency is the smallest of them, collisions can only over count
+	//every sample_size increments all counters are halved so old popularity fades away
+	class MyCountMinSketch
+	{
+		std::vector<uint64_t> table_; //16 counters per word
+		size_t table_mask_ = 0;
+		size_t sample_size_ = 0;
+		size_t additions_ = 0;
+
+	public:
+		void ensure_capacity(size_t maximum_size);
+		[[nodiscard]] int frequency(uint64_t hash) const;
+		void increment(uint64_t hash);
+		void clear();
+		[[nodiscard]] size_t get_sample_size() const;
+
+	private:
+		void age();
+		bool increment_at(size_t index, int counter);
+		[[nodiscard]] size_t index_of(uint64_t hash, int row) const;
+		static uint64_t spread(uint64_t hash);
+	};
+}
@@ -0,0 +1,536 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DS_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ds
+{
+	//one control byte per slot, EMPTY and DELETED have the top bit set, a full slot holds 7 bits of its hash
+	constexpr int8_t FLAT_HASH_EMPTY = -128;
+	constexpr int8_t FLAT_HASH_DELETED = -2;
+
+	//a group of control bytes compared all at once, 16 with SSE2 and 8 packed into a uint64_t without it
+	//each match is a bit mask with one bit (or byte) per control byte, lowest is the first slot of the group
+	class FlatHashGroup
+	{
+	public:
+#if DS_FLAT_HASH_SSE2
+		static constexpr size_t WIDTH = 16;
+		using Mask = uint32_t;
+
+		explicit FlatHashGroup(const int8_t* control) : control_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) {}
+		Mask match(int8_t h2) const
+		{
+			return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), control_)));
+		}
+		Mask match_empty() const
+		{
+			return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(FLAT_HASH_EMPTY), control_)));
+		}
+		Mask match_empty_or_deleted() const
+		{
+			return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), control_)));
+		}
+		static size_t index_of(int bit) { return static_cast<size_t>(bit); }
+
+	private:
+		__m128i control_;
+#else
+		static constexpr size_t WIDTH = 8;
+		using Mask = uint64_t;
+
+		//the byte order assumes a little endian machine
+		explicit FlatHashGroup(const int8_t* control) { std::memcpy(&control_, control, sizeof(control_)); }
+		//can report a false match next to a real one, callers compare keys anyway
+		Mask match(int8_t h2) const
+		{
+			const uint64_t difference = control_ ^ (LSBS * static_cast<uint8_t>(h2));
+			return (difference - LSBS) & ~difference & MSBS;
+		}
+		Mask match_empty() const { return control_ & (~control_ << 6) & MSBS; }
+		Mask match_empty_or_deleted() const { return control_ & (~control_ << 7) & MSBS; }
+		static size_t index_of(int bit) { return static_cast<size_t>(bit) >> 3; }
+
+	private:
+		static constexpr uint64_t LSBS = 0x0101010101010101ull;
+		static constexpr uint64_t MSBS = 0x8080808080808080ull;
+		uint64_t control_;
+#endif
+
+	public:
+		static int lowest_bit(uint64_t mask)
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			if (_BitScanForward(&index, static_cast<unsigned long>(mask))) return static_cast<int>(index);
+			_BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+			return static_cast<int>(index) + 32;
+#else
+			return __builtin_ctzll(mask);
+#endif
+		}
+		static int highest_bit(uint64_t mask)
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			if (_BitScanReverse(&index, static_cast<unsigned long>(mask >> 32))) return static_cast<int>(index) + 32;
+			_BitScanReverse(&index, static_cast<unsigned long>(mask));
+			return static_cast<int>(index);
+#else
+			return 63 - __builtin_clzll(mask);
+#endif
+		}
+	};
+
+	//gets the key out of a key value pair slot
+	struct PairKey
+	{
+		template<typename TPair>
+		const auto& operator()(const TPair& slot) const { return slot.first; }
+	};
+
+	//true when a hash or equality functor says it takes other types than the key through is_transparent
+	template<typename T, typename = void>
+	struct IsTransparent : std::false_type {};
+	template<typename T>
+	struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+	//the default hash and equality of the tables below, std::hash and std::equal_to except for std::string, which
+	//is looked up by anything that converts to a std::string_view, so a string_view or a const char* probe
+	//doesn't have to build (and allocate) a std::string first
+	//specialize both for other keys that have a cheaper form to look them up by
+	template<typename TKey>
+	struct LookupHash : std::hash<TKey> {};
+	template<typename TKey>
+	struct LookupEqual : std::equal_to<TKey> {};
+
+	template<>
+	struct LookupHash<std::string>
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+	};
+	template<>
+	struct LookupEqual<std::string> : std::equal_to<> {};
+
+	//open addressing hash table in the swiss table style, slots sit in one flat array beside an array of control bytes
+	//a lookup loads a whole group of control bytes and compares them against 7 bits of the hash in one go, so it
+	//usually touches one control line and the one slot that matches, with no nodes or bucket pointers to chase
+	//
+	//TKeyOf(slot) gives a slot's key so a slot can carry its own key, MyFlatHashMap below is the usual key value map
+	//slots move when the table grows, pointers to them are only good until the next insert
+	//find, contains and erase take any key-like type when THash and TEqual are both transparent, otherwise the
+	//lookup is converted to a TKey first
+	template<typename TKey, typename TSlot, typename TKeyOf, typename THash = LookupHash<TKey>, typename TEqual = LookupEqual<TKey>>
+	class MyFlatHashTable
+	{
+		static constexpr size_t WIDTH = FlatHashGroup::WIDTH;
+
+		int8_t* control_ = nullptr; //capacity_ bytes then the first WIDTH bytes again, so a group never wraps
+		TSlot* slots_ = nullptr;
+		size_t capacity_ = 0; //0 or a power of two, at least WIDTH
+		size_t size_ = 0;
+		size_t growth_left_ = 0; //inserts until the table is 7/8 full, deleted slots count as full
+		THash hash_;
+		TEqual equal_;
+		TKeyOf key_of_;
+
+		static constexpr bool TRANSPARENT = IsTransparent<THash>::value && IsTransparent<TEqual>::value;
+
+		static size_t max_load(size_t capacity);
+		static size_t capacity_for(size_t count);
+		template<typename TLookup>
+		uint64_t hash_of(const TLookup& key) const;
+		static int8_t h2_of(uint64_t hash);
+		void set_control(size_t index, int8_t control);
+		template<typename TLookup>
+		size_t find_index(const TLookup& key, uint64_t hash) const;
+		template<typename TLookup>
+		size_t locate(const TLookup& key) const;
+		size_t find_first_non_full(uint64_t hash) const;
+		void rehash(size_t capacity);
+		void release();
+
+	public:
+		MyFlatHashTable() = default;
+		MyFlatHashTable(const MyFlatHashTable&) = delete;
+		MyFlatHashTable& operator=(const MyFlatHashTable&) = delete;
+		~MyFlatHashTable();
+
+		template<typename TLookup = TKey>
+		TSlot* find(const TLookup& key);
+		template<typename TLookup = TKey>
+		const TSlot* find(const TLookup& key) const;
+		template<typename TLookup = TKey>
+		bool contains(const TLookup& key) const;
+		std::pair<TSlot*, bool> insert(TSlot slot);
+		template<typename TLookup = TKey>
+		bool erase(const TLookup& key);
+		void reserve(size_t count);
+		void clear();
+		template<typename TVisit>
+		void for_each(TVisit visit);
+
+		size_t size() const;
+		bool is_empty() const;
+		size_t get_capacity() const;
+		size_t allocated_bytes() const;
+	};
+
+	template<typename TKey, typename TValue, typename THash = LookupHash<TKey>, typename TEqual = LookupEqual<TKey>>
+	using MyFlatHashMap = MyFlatHashTable<TKey, std::pair<TKey, TValue>, PairKey, THash, TEqual>;
+
+	//O(1)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::max_load(size_t capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	//O(log count)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::capacity_for(size_t count)
+	{
+		size_t capacity = WIDTH;
+		while (max_load(capacity) < count)
+		{
+			capacity *= 2;
+		}
+		return capacity;
+	}
+
+	//O(1)
+	//std::hash of an integer is usually the integer itself, the multiply spreads it over every bit
+	//the top 7 bits become h2 and the folded low bits pick where probing starts
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	uint64_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::hash_of(const TLookup& key) const
+	{
+		const uint64_t product = static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+		return product ^ (product >> 32);
+	}
+
+	//O(1)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	int8_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::h2_of(uint64_t hash)
+	{
+		return static_cast<int8_t>(hash >> 57);
+	}
+
+	//O(1)
+	//keeps the copy of the first group at the end in step
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	void MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::set_control(size_t index, int8_t control)
+	{
+		control_[index] = control;
+		if (index < WIDTH)
+		{
+			control_[capacity_ + index] = control;
+		}
+	}
+
+	//O(1) expected
+	//probes group by group with growing strides until a group with an empty slot, returns capacity_ when missing
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::find_index(const TLookup& key, uint64_t hash) const
+	{
+		const size_t mask = capacity_ - 1;
+		const int8_t h2 = h2_of(hash);
+		size_t position = static_cast<size_t>(hash) & mask;
+		for (size_t stride = WIDTH; ; stride += WIDTH)
+		{
+			const FlatHashGroup group(control_ + position);
+			for (auto matches = group.match(h2); matches != 0; matches &= matches - 1)
+			{
+				const size_t index = (position + FlatHashGroup::index_of(FlatHashGroup::lowest_bit(matches))) & mask;
+				if (equal_(key_of_(slots_[index]), key))
+				{
+					return index;
+				}
+			}
+			if (group.match_empty() != 0)
+			{
+				return capacity_;
+			}
+			position = (position + stride) & mask;
+		}
+	}
+
+	//O(1) expected
+	//returns capacity_ when missing, a key-like lookup only skips the conversion to TKey when the functors are transparent
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::locate(const TLookup& key) const
+	{
+		if (size_ == 0)
+		{
+			return capacity_;
+		}
+		if constexpr (TRANSPARENT || std::is_same_v<TLookup, TKey>)
+		{
+			return find_index(key, hash_of(key));
+		}
+		else
+		{
+			const TKey converted(key);
+			return find_index(converted, hash_of(converted));
+		}
+	}
+
+	//O(1) expected
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::find_first_non_full(uint64_t hash) const
+	{
+		const size_t mask = capacity_ - 1;
+		size_t position = static_cast<size_t>(hash) & mask;
+		for (size_t stride = WIDTH; ; stride += WIDTH)
+		{
+			const auto free = FlatHashGroup(control_ + position).match_empty_or_deleted();
+			if (free != 0)
+			{
+				return (position + FlatHashGroup::index_of(FlatHashGroup::lowest_bit(free))) & mask;
+			}
+			position = (position + stride) & mask;
+		}
+	}
+
+	//O(n)
+	//moves every slot into fresh arrays of the given capacity, which also drops the deleted markers
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	void MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::rehash(size_t capacity)
+	{
+		int8_t* old_control = control_;
+		TSlot* old_slots = slots_;
+		const size_t old_capacity = capacity_;
+
+		control_ = new int8_t[capacity + WIDTH];
+		std::memset(control_, FLAT_HASH_EMPTY, capacity + WIDTH);
+		slots_ = std::allocator<TSlot>().allocate(capacity);
+		capacity_ = capacity;
+		growth_left_ = max_load(capacity) - size_;
+
+		for (size_t index = 0; index < old_capacity; index++)
+		{
+			if (old_control[index] < 0)
+			{
+				continue;
+			}
+			const uint64_t hash = hash_of(key_of_(old_slots[index]));
+			const size_t target = find_first_non_full(hash);
+			new (&slots_[target]) TSlot(std::move(old_slots[index]));
+			old_slots[index].~TSlot();
+			set_control(target, h2_of(hash));
+		}
+		if (old_control != nullptr)
+		{
+			delete[] old_control;
+			std::allocator<TSlot>().deallocate(old_slots, old_capacity);
+		}
+	}
+
+	//O(n)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	void MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::release()
+	{
+		if (control_ == nullptr)
+		{
+			return;
+		}
+		clear();
+		delete[] control_;
+		std::allocator<TSlot>().deallocate(slots_, capacity_);
+		control_ = nullptr;
+		slots_ = nullptr;
+		capacity_ = 0;
+		growth_left_ = 0;
+	}
+
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::~MyFlatHashTable()
+	{
+		release();
+	}
+
+	//O(1) expected
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	TSlot* MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::find(const TLookup& key)
+	{
+		const size_t index = locate(key);
+		return index == capacity_ ? nullptr : &slots_[index];
+	}
+
+	//O(1) expected
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	const TSlot* MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::find(const TLookup& key) const
+	{
+		const size_t index = locate(key);
+		return index == capacity_ ? nullptr : &slots_[index];
+	}
+
+	//O(1) expected
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	bool MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::contains(const TLookup& key) const
+	{
+		return find(key) != nullptr;
+	}
+
+	//O(1) amortised
+	//returns the slot holding the key and whether it was inserted, an existing slot is left as it was
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	std::pair<TSlot*, bool> MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::insert(TSlot slot)
+	{
+		const uint64_t hash = hash_of(key_of_(slot));
+		if (size_ != 0)
+		{
+			const size_t existing = find_index(key_of_(slot), hash);
+			if (existing != capacity_)
+			{
+				return { &slots_[existing], false };
+			}
+		}
+
+		size_t index = capacity_ == 0 ? 0 : find_first_non_full(hash);
+		if (growth_left_ == 0 && (capacity_ == 0 || control_[index] != FLAT_HASH_DELETED))
+		{
+			//out of room because of deleted markers rather than entries, rebuilding at the same size clears them,
+			//the 25/32 keeps at least 3/32 of the table free after a rebuild so rebuilds stay amortised O(1)
+			rehash(capacity_ == 0 ? WIDTH : size_ + 1 > capacity_ / 32 * 25 ? capacity_ * 2 : capacity_);
+			index = find_first_non_full(hash);
+		}
+
+		new (&slots_[index]) TSlot(std::move(slot));
+		if (control_[index] == FLAT_HASH_EMPTY)
+		{
+			--growth_left_;
+		}
+		set_control(index, h2_of(hash));
+		++size_;
+		return { &slots_[index], true };
+	}
+
+	//O(1) expected
+	//a slot that no probe can have passed over full goes straight back to empty, otherwise it is marked deleted
+	//so later probes keep going, since a probe only stops at a group with an empty slot, that is only safe when
+	//every window of WIDTH bytes covering the slot has an empty byte in it
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TLookup>
+	bool MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::erase(const TLookup& key)
+	{
+		const size_t index = locate(key);
+		if (index == capacity_)
+		{
+			return false;
+		}
+		slots_[index].~TSlot();
+		--size_;
+
+		const size_t mask = capacity_ - 1;
+		const auto empty_after = FlatHashGroup(control_ + index).match_empty();
+		const auto empty_before = FlatHashGroup(control_ + ((index - WIDTH) & mask)).match_empty();
+		const size_t full_after = empty_after == 0 ? WIDTH : FlatHashGroup::index_of(FlatHashGroup::lowest_bit(empty_after));
+		const size_t full_before = empty_before == 0 ? WIDTH : WIDTH - 1 - FlatHashGroup::index_of(FlatHashGroup::highest_bit(empty_before));
+		if (full_after + full_before < WIDTH)
+		{
+			set_control(index, FLAT_HASH_EMPTY);
+			++growth_left_;
+		}
+		else
+		{
+			set_control(index, FLAT_HASH_DELETED);
+		}
+		return true;
+	}
+
+	//O(n) when it grows
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	void MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::reserve(size_t count)
+	{
+		if (count > size_ + growth_left_)
+		{
+			rehash(capacity_for(count));
+		}
+	}
+
+	//O(capacity)
+	//keeps the arrays for reuse
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	void MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::clear()
+	{
+		if (control_ == nullptr)
+		{
+			return;
+		}
+		for (size_t index = 0; index < capacity_; index++)
+		{
+			if (control_[index] >= 0)
+			{
+				slots_[index].~TSlot();
+			}
+		}
+		std::memset(control_, FLAT_HASH_EMPTY, capacity_ + WIDTH);
+		size_ = 0;
+		growth_left_ = max_load(capacity_);
+	}
+
+	//O(capacity)
+	//visit(slot) for every slot in table order, visit must not insert or erase
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	template <typename TVisit>
+	void MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::for_each(TVisit visit)
+	{
+		for (size_t index = 0; index < capacity_; index++)
+		{
+			if (control_[index] >= 0)
+			{
+				visit(slots_[index]);
+			}
+		}
+	}
+
+	//O(1)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::size() const
+	{
+		return size_;
+	}
+
+	//O(1)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	bool MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::is_empty() const
+	{
+		return size_ == 0;
+	}
+
+	//O(1)
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::get_capacity() const
+	{
+		return capacity_;
+	}
+
+	//O(1)
+	//the table's own arrays, not anything the slots point to
+	template <typename TKey, typename TSlot, typename TKeyOf, typename THash, typename TEqual>
+	size_t MyFlatHashTable<TKey, TSlot, TKeyOf, THash, TEqual>::allocated_bytes() const
+	{
+		return capacity_ == 0 ? 0 : capacity_ * sizeof(TSlot) + capacity_ + WIDTH;
+	}
+}
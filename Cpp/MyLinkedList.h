@@ -1,5 +1,7 @@
 #pragma once
 #include <iostream>
+#include <memory>
+#include <utility>
 #include "Interfaces.h"
 namespace ds
 {
@@ -13,38 +15,51 @@ namespace ds
 		{
 			
 		private:
-			const Type& value_;
+			Type value_;
 		public:
 			NodePtr next_ = nullptr;
 			WeakNodePtr previous_;
-			const Type& get_value();
-			explicit Node(const Type& type);
+			Type& get_value();
+			template<typename... TArgs>
+			explicit Node(TArgs&&... args);
 		};
 
 	private:
 		NodePtr head_ = nullptr;
 		NodePtr tail_ = nullptr;
+		NodePtr removed_ = nullptr; //the last removed node, kept so the reference remove_* handed out stays good
 		int count_ = 0;
 	public:
 		void add_last(const Type&) override;
+		void add_last(Type&&) override;
+		template<typename... TArgs>
+		void emplace_last(TArgs&&... args);
 		const Type& remove_last() override;
+		Type take_last() override;
 		const Type& peek_last() override;
 
 		void add_first(const Type&) override;
+		void add_first(Type&&) override;
+		template<typename... TArgs>
+		void emplace_first(TArgs&&... args);
 		const Type& remove_first() override;
+		Type take_first() override;
 		const Type& peek_first() override;
 
 		int get_count() override;
 
 	private:
 		void validate_non_empty();
+		NodePtr unlink_last();
+		NodePtr unlink_first();
 	};
 
 	template <typename Type>
-	MyLinkedList<Type>::Node::Node(const Type& type) : value_(type) {}
+	template <typename... TArgs>
+	MyLinkedList<Type>::Node::Node(TArgs&&... args) : value_(std::forward<TArgs>(args)...) {}
 
 	template <typename Type>
-	const Type& MyLinkedList<Type>::Node::get_value()
+	Type& MyLinkedList<Type>::Node::get_value()
 	{
 		return value_;
 	}
@@ -52,8 +67,21 @@ namespace ds
 	template <typename Type>
 	void MyLinkedList<Type>::add_last(const Type& item)
 	{
+		emplace_last(item);
+	}
+
+	template <typename Type>
+	void MyLinkedList<Type>::add_last(Type&& item)
+	{
+		emplace_last(std::move(item));
+	}
+
+	template <typename Type>
+	template <typename... TArgs>
+	void MyLinkedList<Type>::emplace_last(TArgs&&... args)
+	{
+		NodePtr node = std::make_shared<Node>(std::forward<TArgs>(args)...);
 		++count_;
-		NodePtr node = std::make_shared<Node>(item);
 		if (head_ == nullptr)
 		{
 			head_ = node;
@@ -69,20 +97,14 @@ namespace ds
 	template <typename Type>
 	const Type& MyLinkedList<Type>::remove_last()
 	{
-		validate_non_empty();
-		--count_;
-		NodePtr prev = tail_->previous_.lock();
-		if (prev != nullptr)
-		{
-			prev->next_ = nullptr;
-		}
-		else
-		{
-			head_ = nullptr;
-		}
-		const Type& result = tail_->get_value();
-		tail_ = prev;
-		return result;
+		removed_ = unlink_last();
+		return removed_->get_value();
+	}
+
+	template <typename Type>
+	Type MyLinkedList<Type>::take_last()
+	{
+		return std::move(unlink_last()->get_value());
 	}
 
 	template <typename Type>
@@ -95,8 +117,21 @@ namespace ds
 	template <typename Type>
 	void MyLinkedList<Type>::add_first(const Type& item)
 	{
+		emplace_first(item);
+	}
+
+	template <typename Type>
+	void MyLinkedList<Type>::add_first(Type&& item)
+	{
+		emplace_first(std::move(item));
+	}
+
+	template <typename Type>
+	template <typename... TArgs>
+	void MyLinkedList<Type>::emplace_first(TArgs&&... args)
+	{
+		NodePtr node = std::make_shared<Node>(std::forward<TArgs>(args)...);
 		++count_;
-		NodePtr node = std::make_shared<Node>(item);
 		if (tail_ == nullptr)
 		{
 			tail_ = node;
@@ -112,20 +147,14 @@ namespace ds
 	template <typename Type>
 	const Type& MyLinkedList<Type>::remove_first()
 	{
-		validate_non_empty();
-		--count_;
-		NodePtr next = head_->next_;
-		if (next != nullptr)
-		{
-			next->previous_.reset();
-		}
-		else
-		{
-			tail_ = nullptr;
-		}
-		const Type& result = head_->get_value();
-		head_ = next;
-		return result;
+		removed_ = unlink_first();
+		return removed_->get_value();
+	}
+
+	template <typename Type>
+	Type MyLinkedList<Type>::take_first()
+	{
+		return std::move(unlink_first()->get_value());
 	}
 
 	template <typename Type>
@@ -149,4 +178,43 @@ namespace ds
 			throw std::exception("data structure is empty");
 		}
 	}
+
+	template <typename Type>
+	typename MyLinkedList<Type>::NodePtr MyLinkedList<Type>::unlink_last()
+	{
+		validate_non_empty();
+		--count_;
+		NodePtr node = tail_;
+		NodePtr prev = node->previous_.lock();
+		if (prev != nullptr)
+		{
+			prev->next_ = nullptr;
+		}
+		else
+		{
+			head_ = nullptr;
+		}
+		tail_ = prev;
+		return node;
+	}
+
+	template <typename Type>
+	typename MyLinkedList<Type>::NodePtr MyLinkedList<Type>::unlink_first()
+	{
+		validate_non_empty();
+		--count_;
+		NodePtr node = head_;
+		NodePtr next = node->next_;
+		if (next != nullptr)
+		{
+			next->previous_.reset();
+		}
+		else
+		{
+			tail_ = nullptr;
+		}
+		head_ = next;
+		node->next_ = nullptr;
+		return node;
+	}
 };
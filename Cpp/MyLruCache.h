@@ -1,155 +1,810 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "MyCachePolicies.h"
+#include "MyCacheSnapshot.h"
+#include "MyCacheStats.h"
+#include "MyFlatHashMap.h"
+#include "MyObjectPool.h"
+#include "MyTimingWheel.h"
 
 namespace ds
 {
 	const int DEFAULT_CAPACITY = 4;
 
-	template<typename TKey, typename TValue>
+	//TPolicy picks what gets evicted, see MyCachePolicies.h, LruPolicy keeps the classic behaviour
+	//
+	//entries put with a time to live are also scheduled on a timing wheel, an entry whose time is up
+	//is treated as missing straight away and its node is reclaimed by the next write or remove_expired
+	//
+	//with a weigher the capacity is a budget for the summed weight of the entries, bytes say,
+	//rather than a count, without one every entry weighs 1
+	//
+	//TStats = CacheStats turns on the counters behind get_stats, see MyCacheStats.h
+	//
+	//save_snapshot and load_snapshot carry the entries over a restart, see MyCacheSnapshot.h
+	//
+	//the reads and remove take any key-like type the key index can hash, a std::string keyed cache can be probed
+	//with a std::string_view without allocating, see LookupHash in MyFlatHashMap.h
+	//
+	//a removal listener is given the key and value of every entry the cache lets go of, and why, they are
+	//queued while the cache is mid change and the listener runs once the call that removed them is done with it
+	template<typename TKey, typename TValue, template<typename> class TPolicy = LruPolicy, typename TStats = NoCacheStats>
 	class MyLruCache
 	{
+		//each entry holds its key and value and carries the policy's and the timer's links,
+		//entries live in a pool so they never move, and the key index is a flat table of pointers to them
+		struct Entry : public TPolicy<Entry>::Hook, public MyTimingWheel<Entry>::Hook
+		{
+			using Key = TKey;
+			TKey key;
+			TValue value;
+			uint64_t time_to_live = 0; //milliseconds, 0 never expires
+			size_t weight = 1;
+
+			template<typename TKeyArg, typename... TArgs>
+			Entry(TKeyArg&& key_arg, std::in_place_t, TArgs&&... value_args)
+				: key(std::forward<TKeyArg>(key_arg)), value(std::forward<TArgs>(value_args)...) {}
+		};
+
+		struct EntryKey
+		{
+			const TKey& operator()(const Entry* entry) const { return entry->key; }
+		};
+
 		size_t capacity_ = DEFAULT_CAPACITY;
-		uint64_t time_ = 0;
-		std::unordered_map<TKey, uint64_t> key_to_last_used;
-		std::map<uint64_t, TKey> last_used_to_key;
-		std::unordered_map<TKey, TValue> key_to_value;
+		size_t weight_ = 0;
+		std::function<size_t(const TKey&, const TValue&)> weigher_;
+		MyFlatHashTable<TKey, Entry*, EntryKey> key_to_entry_;
+		MyObjectPool<Entry> entries_;
+		TPolicy<Entry> policy_;
+		MyTimingWheel<Entry> timers_;
+		std::function<uint64_t()> time_source_ = steady_milliseconds;
+		bool refresh_on_get_ = false;
+		TStats stats_;
+
+	public:
+		using RemovalListener = std::function<void(TKey&&, TValue&&, RemovalCause)>;
 
+		struct Removal
+		{
+			TKey key;
+			TValue value;
+			RemovalCause cause;
+		};
+
+	private:
+		RemovalListener removal_listener_;
+		bool hold_removals_ = false;
+		std::vector<Removal> removals_;
+
+		static uint64_t steady_milliseconds();
+		bool is_expired(const Entry& entry) const;
+		template<typename TKeyArg, typename... TArgs>
+		Entry& upsert(TKeyArg&& key, TArgs&&... value_args);
+		template<typename TKeyArg, typename... TArgs>
+		Entry& store(TKeyArg&& key, size_t weight, TArgs&&... value_args);
+		template<typename... TArgs>
+		static void assign_value(TValue& target, TArgs&&... value_args);
+		template<typename TKeyArg, typename... TArgs>
+		void put_without_expiry(TKeyArg&& key, TArgs&&... value_args);
+		void erase_entry(Entry& entry, RemovalCause cause);
+		void deliver_removals();
 		void remove_excess();
-		uint64_t get_time();
-		
+		template<typename TLookup>
+		TValue* lookup(const TLookup& key);
+
 	public:
+		MyLruCache();
+		MyLruCache(const MyLruCache&) = delete;
+		MyLruCache& operator=(const MyLruCache&) = delete;
+		~MyLruCache();
+
 		size_t size();
+		size_t get_weight() const;
 		size_t get_capacity() const;
 		void set_capacity(size_t capacity);
+		void set_weigher(std::function<size_t(const TKey&, const TValue&)> weigher);
+
+		void set_refresh_on_get(bool refresh);
+		void set_time_source(std::function<uint64_t()> time_source);
+		void set_removal_listener(RemovalListener listener);
+		void set_hold_removals(bool hold);
+		std::vector<Removal> take_removals();
+		void notify_removals(std::vector<Removal>& removals) const;
 
 		void put(const TKey& key, TValue& value);
-		TValue& get(const TKey& key);
-		void remove(const TKey& key);
-		bool contains(const TKey& key);
+		void put(const TKey& key, TValue&& value);
+		void put(TKey&& key, TValue&& value);
+		template<typename TKeyArg, typename... TArgs>
+		void emplace(TKeyArg&& key, TArgs&&... value_args);
+		void put(const TKey& key, TValue& value, std::chrono::milliseconds time_to_live);
+		void put_many(const std::vector<TKey>& keys, std::vector<TValue>& values);
+		template<typename TLookup = TKey>
+		TValue& get(const TLookup& key);
+		template<typename TLookup = TKey>
+		TValue* try_get(const TLookup& key);
+		size_t get_many(const std::vector<TKey>& keys, std::vector<TValue*>& out_values);
+		template<typename TLoader>
+		TValue get_or_load(const TKey& key, TLoader loader);
+		template<typename TLookup = TKey>
+		const TValue* peek(const TLookup& key) const;
+		template<typename TLookup = TKey>
+		bool touch(const TLookup& key);
+		template<typename TLookup = TKey>
+		void remove(const TLookup& key);
+		template<typename TLookup = TKey>
+		bool contains(const TLookup& key);
+		size_t remove_expired();
 		void clear();
 		bool is_full();
 		bool is_empty();
+		CacheStatsSnapshot get_stats() const;
+		template<typename TKeySerializer = SnapshotSerializer<TKey>, typename TValueSerializer = SnapshotSerializer<TValue>>
+		void save_snapshot(std::ostream& out) const;
+		template<typename TKeySerializer = SnapshotSerializer<TKey>, typename TValueSerializer = SnapshotSerializer<TValue>>
+		size_t load_snapshot(std::istream& in);
 	};
 
-	//O(n log n) 
-	template <typename TKey, typename TValue>
-	void MyLruCache<TKey, TValue>::remove_excess()
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	MyLruCache<TKey, TValue, TPolicy, TStats>::MyLruCache()
+	{
+		policy_.set_capacity(capacity_, false);
+	}
+
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	MyLruCache<TKey, TValue, TPolicy, TStats>::~MyLruCache()
+	{
+		removal_listener_ = nullptr; //going away isn't a removal
+		clear();
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	uint64_t MyLruCache<TKey, TValue, TPolicy, TStats>::steady_milliseconds()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	//O(1)
+	//goes by the clock rather than the wheel, so an entry is hidden the moment its time is up
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	bool MyLruCache<TKey, TValue, TPolicy, TStats>::is_expired(const Entry& entry) const
+	{
+		return entry.expires_at != 0 && entry.expires_at <= time_source_();
+	}
+
+	//O(1) amortised
+	//stores the value without enforcing capacity so the caller can set up the timer first
+	//an entry that would be over the budget on its own is refused, and any older value for the key
+	//is dropped rather than left behind stale
+	//without a weigher the value is built straight in the map node from value_args
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeyArg, typename... TArgs>
+	typename MyLruCache<TKey, TValue, TPolicy, TStats>::Entry& MyLruCache<TKey, TValue, TPolicy, TStats>::upsert(TKeyArg&& key, TArgs&&... value_args)
 	{
-		while(size() > get_capacity())
+		if (!weigher_)
 		{
-			auto& [last_used, key] = *last_used_to_key.begin();
-			key_to_value.erase(key);
-			key_to_last_used.erase(key);
-			last_used_to_key.erase(last_used);
+			return store(std::forward<TKeyArg>(key), 1, std::forward<TArgs>(value_args)...);
 		}
+
+		TValue value(std::forward<TArgs>(value_args)...); //has to exist before it can be weighed
+		const size_t weight = weigher_(key, value);
+		if (weight > capacity_)
+		{
+			Entry** got = key_to_entry_.find(key);
+			if (got != nullptr)
+			{
+				policy_.on_remove(**got);
+				erase_entry(**got, RemovalCause::Capacity);
+				stats_.record_eviction(RemovalCause::Capacity);
+				deliver_removals();
+			}
+			throw std::exception("entry heavier than capacity");
+		}
+		return store(std::forward<TKeyArg>(key), weight, std::move(value));
+	}
+
+	//O(1) amortised
+	//key and value_args are only moved from when the key is new, so they are still there to assign from otherwise
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeyArg, typename... TArgs>
+	typename MyLruCache<TKey, TValue, TPolicy, TStats>::Entry& MyLruCache<TKey, TValue, TPolicy, TStats>::store(TKeyArg&& key, size_t weight, TArgs&&... value_args)
+	{
+		Entry** got = key_to_entry_.find(key);
+		if (got == nullptr)
+		{
+			Entry* entry = entries_.make(std::forward<TKeyArg>(key), std::in_place, std::forward<TArgs>(value_args)...);
+			try
+			{
+				key_to_entry_.insert(entry);
+			}
+			catch (...)
+			{
+				entries_.release(entry);
+				throw;
+			}
+			entry->weight = weight;
+			policy_.on_insert(*entry);
+			weight_ += weight;
+			stats_.record_weight(weight_);
+			return *entry;
+		}
+
+		Entry& entry = **got;
+		if (removal_listener_)
+		{
+			TValue replaced = std::move(entry.value);
+			assign_value(entry.value, std::forward<TArgs>(value_args)...);
+			removals_.push_back({ entry.key, std::move(replaced), RemovalCause::Replaced });
+		}
+		else
+		{
+			assign_value(entry.value, std::forward<TArgs>(value_args)...);
+		}
+		if (entry.weight == weight)
+		{
+			policy_.on_access(entry);
+			return entry;
+		}
+		//the policy sums weights as entries come and go, so it has to see the entry leave and come back
+		policy_.on_remove(entry);
+		weight_ -= entry.weight;
+		entry.weight = weight;
+		policy_.on_insert(entry);
+		weight_ += weight;
+		stats_.record_weight(weight_);
+		return entry;
 	}
 
 	//O(1)
-	template <typename TKey, typename TValue>
-	uint64_t MyLruCache<TKey, TValue>::get_time()
+	//a single TValue argument is copied or moved in directly rather than through a temporary
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename... TArgs>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::assign_value(TValue& target, TArgs&&... value_args)
 	{
-		return ++time_;
+		if constexpr (sizeof...(TArgs) == 1 && (std::is_same_v<std::decay_t<TArgs>, TValue> && ...))
+		{
+			((target = std::forward<TArgs>(value_args)), ...);
+		}
+		else
+		{
+			target = TValue(std::forward<TArgs>(value_args)...);
+		}
 	}
 
-	//O(1) 
-	template <typename TKey, typename TValue>
-	size_t MyLruCache<TKey, TValue>::size()
+	//O(1) amortised
+	//what every put without a time to live comes down to
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeyArg, typename... TArgs>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::put_without_expiry(TKeyArg&& key, TArgs&&... value_args)
 	{
-		return key_to_value.size();
+		if (!timers_.is_empty())
+		{
+			remove_expired();
+		}
+		stats_.record_put();
+		Entry& entry = upsert(std::forward<TKeyArg>(key), std::forward<TArgs>(value_args)...);
+		entry.time_to_live = 0;
+		timers_.cancel(entry);
+
+		remove_excess();
+		deliver_removals();
 	}
 
-	//O(1) 
-	template <typename TKey, typename TValue>
-	size_t MyLruCache<TKey, TValue>::get_capacity() const
+	//O(1)
+	//caller has already taken the entry out of the policy
+	//with a listener the key and value are moved onto the removal queue before the entry goes back to the pool
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::erase_entry(Entry& entry, RemovalCause cause)
+	{
+		timers_.cancel(entry);
+		weight_ -= entry.weight;
+		stats_.record_weight(weight_);
+		key_to_entry_.erase(entry.key);
+		if (removal_listener_)
+		{
+			try
+			{
+				removals_.push_back({ std::move(entry.key), std::move(entry.value), cause });
+			}
+			catch (...)
+			{
+				entries_.release(&entry);
+				throw;
+			}
+		}
+		entries_.release(&entry);
+	}
+
+	//O(removals)
+	//called once the cache is done changing, so a listener can use the cache itself
+	//the queue is swapped out first, removals a listener causes are delivered by the call that caused them
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::deliver_removals()
+	{
+		if (hold_removals_ || removals_.empty())
+		{
+			return;
+		}
+		std::vector<Removal> removals = take_removals();
+		notify_removals(removals);
+	}
+
+	//O(1) per evicted entry
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::remove_excess()
+	{
+		while(weight_ > get_capacity())
+		{
+			Entry* victim = policy_.pop_victim();
+			erase_entry(*victim, RemovalCause::Capacity);
+			stats_.record_eviction(RemovalCause::Capacity);
+		}
+	}
+
+	//O(1)
+	//can include expired entries that haven't been reclaimed yet
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyLruCache<TKey, TValue, TPolicy, TStats>::size()
+	{
+		return key_to_entry_.size();
+	}
+
+	//O(1)
+	//same as size unless there is a weigher
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyLruCache<TKey, TValue, TPolicy, TStats>::get_weight() const
+	{
+		return weight_;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyLruCache<TKey, TValue, TPolicy, TStats>::get_capacity() const
 	{
 		return capacity_;
 	}
 
-	//O(n log n) worse case
+	//O(n) worse case
 	//O(1) best case
-	template <typename TKey, typename TValue>
-	void MyLruCache<TKey, TValue>::set_capacity(size_t capacity)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::set_capacity(size_t capacity)
 	{
 		capacity_ = capacity;
+		policy_.set_capacity(capacity, weigher_ != nullptr);
 		remove_excess();
+		deliver_removals();
 	}
 
-	//O(log n)
-	template <typename TKey, typename TValue>
-	void MyLruCache<TKey, TValue>::put(const TKey& key, TValue& value)
+	//O(1)
+	//weigher(key, value) gives an entry's weight, pass nullptr to go back to counting entries
+	//can only be changed while the cache is empty since the stored weights would be stale
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::set_weigher(std::function<size_t(const TKey&, const TValue&)> weigher)
 	{
-		if (contains(key))
+		if (!is_empty())
 		{
-			uint64_t old_time = key_to_last_used[key];
-			last_used_to_key.erase(old_time);
+			throw std::exception("weigher changed on a non empty cache");
 		}
-		uint64_t time = get_time();
-		key_to_value[key] = value;
-		key_to_last_used[key] = time;
-		last_used_to_key[time] = key;
+		weigher_ = std::move(weigher);
+		policy_.set_capacity(capacity_, weigher_ != nullptr);
+	}
+
+	//O(1)
+	//when set a hit on an entry with a time to live restarts its countdown, sliding expiry for sessions
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::set_refresh_on_get(bool refresh)
+	{
+		refresh_on_get_ = refresh;
+	}
+
+	//O(1)
+	//time_source returns milliseconds from any fixed point, steady_clock by default, mainly for tests
+	//should be set while the cache holds no entries with a time to live
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::set_time_source(std::function<uint64_t()> time_source)
+	{
+		time_source_ = std::move(time_source);
+	}
+
+	//O(1)
+	//listener(key, value, cause) gets each entry the cache lets go of from now on, pass nullptr to stop
+	//a replaced value comes with a copy of its key since the key stays cached, the rest get theirs moved
+	//a listener must not throw, anything it throws is dropped so the removals after it are still delivered
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::set_removal_listener(RemovalListener listener)
+	{
+		removal_listener_ = std::move(listener);
+	}
+
+	//O(1)
+	//while held, removals stay queued until take_removals, for an owner that guards the cache with a lock
+	//and wants the listener to run after it has let go of it
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::set_hold_removals(bool hold)
+	{
+		hold_removals_ = hold;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	std::vector<typename MyLruCache<TKey, TValue, TPolicy, TStats>::Removal> MyLruCache<TKey, TValue, TPolicy, TStats>::take_removals()
+	{
+		std::vector<Removal> removals;
+		removals.swap(removals_);
+		return removals;
+	}
+
+	//O(removals)
+	//runs the listener over removals taken from this cache, needs no lock as long as the listener isn't being changed
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::notify_removals(std::vector<Removal>& removals) const
+	{
+		if (!removal_listener_)
+		{
+			return;
+		}
+		for (Removal& removal : removals)
+		{
+			try
+			{
+				removal_listener_(std::move(removal.key), std::move(removal.value), removal.cause);
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+
+	//O(1) amortised
+	//overwriting a key drops any time to live it had
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::put(const TKey& key, TValue& value)
+	{
+		put_without_expiry(key, value);
+	}
+
+	//O(1) amortised
+	//moves the value in instead of copying it
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::put(const TKey& key, TValue&& value)
+	{
+		put_without_expiry(key, std::move(value));
+	}
+
+	//O(1) amortised
+	//the key is only moved into the map if it is new
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::put(TKey&& key, TValue&& value)
+	{
+		put_without_expiry(std::move(key), std::move(value));
+	}
+
+	//O(1) amortised
+	//builds the value in place from value_args, as if by TValue(value_args...), so a new entry costs no copy or move
+	//a key that is already cached gets a freshly built value assigned
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeyArg, typename... TArgs>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::emplace(TKeyArg&& key, TArgs&&... value_args)
+	{
+		put_without_expiry(std::forward<TKeyArg>(key), std::forward<TArgs>(value_args)...);
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::put(const TKey& key, TValue& value, std::chrono::milliseconds time_to_live)
+	{
+		remove_expired();
+		stats_.record_put();
+		Entry& entry = upsert(key, value);
+		entry.time_to_live = static_cast<uint64_t>(std::max<int64_t>(time_to_live.count(), 1));
+		timers_.schedule(entry, time_source_() + entry.time_to_live);
 
 		remove_excess();
+		deliver_removals();
 	}
 
-	//O(log n)
-	template <typename TKey, typename TValue>
-	TValue& MyLruCache<TKey, TValue>::get(const TKey& key)
+	//O(keys) amortised
+	//same as putting each pair in turn, expired entries are only swept once for the whole batch
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::put_many(const std::vector<TKey>& keys, std::vector<TValue>& values)
 	{
-		auto got = key_to_value.find(key);
-		if (got == key_to_value.end())
+		if (keys.size() != values.size())
+		{
+			throw std::exception("keys and values differ in length");
+		}
+		if (!timers_.is_empty())
+		{
+			remove_expired();
+		}
+		for (size_t index = 0; index < keys.size(); index++)
+		{
+			put_without_expiry(keys[index], values[index]);
+		}
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	TValue& MyLruCache<TKey, TValue, TPolicy, TStats>::get(const TLookup& key)
+	{
+		TValue* value = try_get(key);
+		if (value == nullptr)
 		{
 			throw std::exception("key not in lru");
 		}
-		uint64_t old_time = key_to_last_used[key];
-		last_used_to_key.erase(old_time);
-		uint64_t new_time = get_time();
-		key_to_last_used[key] = new_time;
-		last_used_to_key[new_time] = key;
-		return (*got).second;
+		return *value;
+	}
+
+	//O(1)
+	//same as get but returns nullptr instead of throwing, so callers can test and fetch with one lookup
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	TValue* MyLruCache<TKey, TValue, TPolicy, TStats>::try_get(const TLookup& key)
+	{
+		TValue* value = lookup(key);
+		if (value == nullptr)
+		{
+			stats_.record_miss();
+		}
+		else
+		{
+			stats_.record_hit();
+		}
+		return value;
+	}
+
+	//O(1)
+	//try_get without the hit and miss counts, touch replays reads that were already counted
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	TValue* MyLruCache<TKey, TValue, TPolicy, TStats>::lookup(const TLookup& key)
+	{
+		Entry** got = key_to_entry_.find(key);
+		if (got != nullptr && is_expired(**got))
+		{
+			policy_.on_remove(**got);
+			erase_entry(**got, RemovalCause::Expired);
+			stats_.record_eviction(RemovalCause::Expired);
+			deliver_removals();
+			got = nullptr;
+		}
+		if (got == nullptr)
+		{
+			policy_.on_miss(key);
+			return nullptr;
+		}
+		Entry& entry = **got;
+		policy_.on_access(entry);
+		if (refresh_on_get_ && entry.time_to_live != 0)
+		{
+			timers_.schedule(entry, time_source_() + entry.time_to_live);
+		}
+		return &entry.value;
+	}
+
+	//O(keys)
+	//out_values[i] is what try_get(keys[i]) would give, returns the number of hits
+	//the pointers are only good until the next write
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyLruCache<TKey, TValue, TPolicy, TStats>::get_many(const std::vector<TKey>& keys, std::vector<TValue*>& out_values)
+	{
+		out_values.resize(keys.size());
+		size_t hits = 0;
+		for (size_t index = 0; index < keys.size(); index++)
+		{
+			out_values[index] = try_get(keys[index]);
+			hits += out_values[index] != nullptr ? 1 : 0;
+		}
+		return hits;
 	}
 
-	//O(log n)
-	template <typename TKey, typename TValue>
-	void MyLruCache<TKey, TValue>::remove(const TKey& key)
+	//O(1) plus the loader on a miss
+	//loader(key) returns the value to cache, if it throws nothing is cached and the exception propagates
+	//returns a copy since with a tiny capacity the loaded value may already be evicted again
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLoader>
+	TValue MyLruCache<TKey, TValue, TPolicy, TStats>::get_or_load(const TKey& key, TLoader loader)
+	{
+		TValue* value = try_get(key);
+		if (value != nullptr)
+		{
+			return *value;
+		}
+		const std::chrono::steady_clock::time_point started = start_load_timer<TStats>();
+		std::optional<TValue> loaded; //built by the loader in place, TValue needn't be default constructible
+		try
+		{
+			loaded.emplace(loader(key));
+		}
+		catch (...)
+		{
+			stats_.record_load(false, nanoseconds_since<TStats>(started));
+			throw;
+		}
+		stats_.record_load(true, nanoseconds_since<TStats>(started));
+		put(key, *loaded);
+		return std::move(*loaded);
+	}
+
+	//O(1)
+	//looks a value up without counting it as a use, safe to call from several readers at once
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	const TValue* MyLruCache<TKey, TValue, TPolicy, TStats>::peek(const TLookup& key) const
 	{
-		auto got = key_to_last_used.find(key);
-		if (got == key_to_last_used.end())
+		Entry* const* got = key_to_entry_.find(key);
+		if (got == nullptr || is_expired(**got))
+		{
+			return nullptr;
+		}
+		return &(*got)->value;
+	}
+
+	//O(1)
+	//marks key as most recently used, returns false if it is no longer in the lru
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	bool MyLruCache<TKey, TValue, TPolicy, TStats>::touch(const TLookup& key)
+	{
+		return lookup(key) != nullptr;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::remove(const TLookup& key)
+	{
+		Entry** got = key_to_entry_.find(key);
+		if (got == nullptr || is_expired(**got))
 		{
 			throw std::exception("key not in lru");
 		}
-		auto [_, time] = *got;
-		last_used_to_key.erase(time);
-		key_to_last_used.erase(key);
-		key_to_value.erase(key);
+		policy_.on_remove(**got);
+		erase_entry(**got, RemovalCause::Explicit);
+		stats_.record_removal();
+		deliver_removals();
 	}
 
 	//O(1)
-	template <typename TKey, typename TValue>
-	bool MyLruCache<TKey, TValue>::contains(const TKey& key)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TLookup>
+	bool MyLruCache<TKey, TValue, TPolicy, TStats>::contains(const TLookup& key)
 	{
-		return key_to_value.find(key) != key_to_value.end();
+		return peek(key) != nullptr;
+	}
+
+	//O(expired) amortised
+	//reclaims every entry whose time is up, returns how many went
+	//writes already call this, so it is only needed to free memory in a cache that isn't written to
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	size_t MyLruCache<TKey, TValue, TPolicy, TStats>::remove_expired()
+	{
+		size_t removed = 0; //an empty wheel just jumps to now, which keeps the next schedule on the finest level
+		timers_.advance(time_source_(), [this, &removed](Entry& entry)
+		{
+			policy_.on_remove(entry);
+			erase_entry(entry, RemovalCause::Expired);
+			stats_.record_eviction(RemovalCause::Expired);
+			++removed;
+		});
+		deliver_removals();
+		return removed;
 	}
 
 	//O(n)
-	template <typename TKey, typename TValue>
-	void MyLruCache<TKey, TValue>::clear()
+	//every entry goes to the removal listener as an explicit removal
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::clear()
 	{
-		key_to_value.clear();
-		last_used_to_key.clear();
-		key_to_last_used.clear();
-		time_ = 0;
+		if (removal_listener_)
+		{
+			removals_.reserve(removals_.size() + key_to_entry_.size());
+			key_to_entry_.for_each([this](Entry* entry) { removals_.push_back({ std::move(entry->key), std::move(entry->value), RemovalCause::Explicit }); });
+		}
+		key_to_entry_.for_each([this](Entry* entry) { entries_.release(entry); });
+		key_to_entry_.clear();
+		policy_.clear();
+		timers_.clear();
+		weight_ = 0;
+		stats_.record_weight(0);
+		deliver_removals();
 	}
 
 	//O(1)
-	template <typename TKey, typename TValue>
-	bool MyLruCache<TKey, TValue>::is_full()
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	bool MyLruCache<TKey, TValue, TPolicy, TStats>::is_full()
 	{
-		return size() == get_capacity();
+		return get_weight() >= get_capacity();
 	}
 
 	//O(1)
-	template <typename TKey, typename TValue>
-	bool MyLruCache<TKey, TValue>::is_empty()
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	bool MyLruCache<TKey, TValue, TPolicy, TStats>::is_empty()
 	{
 		return size() == 0;
 	}
+
+	//O(1)
+	//all zeros unless the cache was built with CacheStats, can be called while other threads use the cache
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	CacheStatsSnapshot MyLruCache<TKey, TValue, TPolicy, TStats>::get_stats() const
+	{
+		return stats_.snapshot();
+	}
+
+	//O(n)
+	//writes the live entries coldest first, expired ones are left out
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeySerializer, typename TValueSerializer>
+	void MyLruCache<TKey, TValue, TPolicy, TStats>::save_snapshot(std::ostream& out) const
+	{
+		const uint64_t now = time_source_(); //read once so the count and the records agree
+		auto is_live = [now](const Entry& entry) { return entry.expires_at == 0 || entry.expires_at > now; };
+
+		uint64_t count = 0;
+		policy_.for_each_coldest_first([&](const Entry& entry) { count += is_live(entry) ? 1 : 0; });
+		write_snapshot_header(out, count);
+		policy_.for_each_coldest_first([&](const Entry& entry)
+		{
+			if (!is_live(entry))
+			{
+				return;
+			}
+			TKeySerializer::write(out, entry.key);
+			TValueSerializer::write(out, entry.value);
+			write_snapshot_u64(out, entry.time_to_live);
+			write_snapshot_u64(out, entry.expires_at == 0 ? 0 : entry.expires_at - now);
+		});
+		if (!out)
+		{
+			throw std::exception("could not write snapshot");
+		}
+	}
+
+	//O(n) amortised
+	//puts the snapshot's entries coldest first, so with LruPolicy the recency order comes back exactly,
+	//other policies get the same order but have to relearn what they kept beside it
+	//one record is read at a time and moved into the cache, a snapshot bigger than the capacity
+	//just evicts its own coldest entries as it goes, returns the number of records read
+	//meant for an empty cache, keys already cached are overwritten
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats>
+	template <typename TKeySerializer, typename TValueSerializer>
+	size_t MyLruCache<TKey, TValue, TPolicy, TStats>::load_snapshot(std::istream& in)
+	{
+		const uint64_t count = read_snapshot_header(in);
+		if (!timers_.is_empty())
+		{
+			remove_expired();
+		}
+		for (uint64_t record = 0; record < count; record++)
+		{
+			TKey key = TKeySerializer::read(in);
+			TValue value = TValueSerializer::read(in);
+			const uint64_t time_to_live = read_snapshot_u64(in);
+			const uint64_t time_left = read_snapshot_u64(in);
+
+			stats_.record_put();
+			Entry& entry = upsert(std::move(key), std::move(value));
+			entry.time_to_live = time_to_live;
+			if (time_left == 0)
+			{
+				timers_.cancel(entry);
+			}
+			else
+			{
+				timers_.schedule(entry, time_source_() + time_left);
+			}
+			remove_excess();
+			deliver_removals();
+		}
+		return static_cast<size_t>(count);
+	}
 }
@@ -0,0 +1,259 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "MyCachePolicies.h"
+#include "MyCacheSnapshot.h"
+#include "MyFlatHashMap.h"
+#include "MyMappedFile.h"
+#include "MyObjectPool.h"
+#include "MySlabAllocator.h"
+
+namespace ds
+{
+	//a cache tier whose values live off heap in a memory mapped file, carved up by a MySlabAllocator,
+	//only the keys and a few words per entry stay in memory, in a flat index like MyLruCache's
+	//values are written by TValueSerializer, see MyCacheSnapshot.h, straight into their chunk and read back
+	//from it in place, so a hit costs at most the page faults of its own chunk
+	//
+	//each size class keeps its own lru, when a class is out of chunks its least recent entry makes room,
+	//the same as memcached, a value bigger than a slab page is not stored
+	//meant to sit behind a MyLruCache, see MyTieredLruCache.h, take hands an entry back and forgets it
+	template<typename TKey, typename TValue, typename TValueSerializer = SnapshotSerializer<TValue>>
+	class MyMappedCacheTier
+	{
+		struct Item
+		{
+			TKey key;
+			Item* newer = nullptr;
+			Item* older = nullptr;
+			size_t weight = 1;
+			uint64_t offset;
+			uint32_t length;
+			int size_class;
+
+			template<typename TKeyArg>
+			Item(TKeyArg&& key_arg, uint64_t item_offset, uint32_t item_length, int item_class)
+				: key(std::forward<TKeyArg>(key_arg)), offset(item_offset), length(item_length), size_class(item_class) {}
+		};
+
+		struct ItemKey
+		{
+			const TKey& operator()(const Item* item) const { return item->key; }
+		};
+
+		MyMappedFile file_;
+		MySlabAllocator slabs_;
+		MyFlatHashTable<TKey, Item*, ItemKey> key_to_item_;
+		MyObjectPool<Item> items_;
+		std::vector<IntrusiveList<Item>> recency_; //one per size class
+		std::vector<char> scratch_; //the value being put, serialized
+
+		static size_t at_least_a_page(size_t bytes);
+		void erase_item(Item& item);
+		TValue read_item(const Item& item) const;
+
+	public:
+		MyMappedCacheTier(const std::string& path, size_t bytes);
+		MyMappedCacheTier(const MyMappedCacheTier&) = delete;
+		MyMappedCacheTier& operator=(const MyMappedCacheTier&) = delete;
+		~MyMappedCacheTier();
+
+		bool put(const TKey& key, const TValue& value);
+		template<typename TLookup = TKey>
+		bool take(const TLookup& key, TValue& out_value);
+		template<typename TLookup = TKey>
+		std::optional<TValue> read(const TLookup& key) const;
+		template<typename TLookup = TKey>
+		bool contains(const TLookup& key) const;
+		template<typename TLookup = TKey>
+		bool remove(const TLookup& key);
+		void clear();
+
+		size_t size() const;
+		size_t get_capacity() const;
+	};
+
+	//O(1)
+	//bytes is the size of the backing file, rounded down to whole slab pages, there has to be at least one
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	MyMappedCacheTier<TKey, TValue, TValueSerializer>::MyMappedCacheTier(const std::string& path, size_t bytes)
+		: file_(path, at_least_a_page(bytes)), slabs_(bytes)
+	{
+		recency_.resize(slabs_.class_count());
+	}
+
+	//O(1)
+	//checked before the file is created, a tier too small for a slab page could never store anything
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	size_t MyMappedCacheTier<TKey, TValue, TValueSerializer>::at_least_a_page(size_t bytes)
+	{
+		if (bytes < SLAB_PAGE_SIZE)
+		{
+			throw std::exception("mapped cache tier needs at least one slab page");
+		}
+		return bytes;
+	}
+
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	MyMappedCacheTier<TKey, TValue, TValueSerializer>::~MyMappedCacheTier()
+	{
+		clear();
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	void MyMappedCacheTier<TKey, TValue, TValueSerializer>::erase_item(Item& item)
+	{
+		recency_[item.size_class].unlink(item);
+		slabs_.release(item.size_class, item.offset);
+		key_to_item_.erase(item.key);
+		items_.release(&item);
+	}
+
+	//O(value size) amortised
+	//replaces any value already stored for key, returns false if the value couldn't be stored, because it
+	//is bigger than a page or its size class never got a page before the file filled up, the old value stays then
+	//the chunk is reserved before the old value goes, which may be the least recent entry evicted to make room
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	bool MyMappedCacheTier<TKey, TValue, TValueSerializer>::put(const TKey& key, const TValue& value)
+	{
+		scratch_.clear();
+		{
+			ByteSink sink(scratch_);
+			std::ostream out(&sink);
+			TValueSerializer::write(out, value);
+		}
+
+		const int size_class = slabs_.class_for(scratch_.size());
+		if (size_class < 0)
+		{
+			return false;
+		}
+		uint64_t offset = 0;
+		while (!slabs_.allocate(size_class, offset))
+		{
+			Item* victim = recency_[size_class].least_recent();
+			if (victim == nullptr)
+			{
+				return false;
+			}
+			erase_item(*victim);
+		}
+
+		Item** existing = key_to_item_.find(key);
+		if (existing != nullptr)
+		{
+			erase_item(**existing);
+		}
+		std::memcpy(file_.data() + offset, scratch_.data(), scratch_.size());
+		Item* item = items_.make(key, offset, static_cast<uint32_t>(scratch_.size()), size_class);
+		try
+		{
+			key_to_item_.insert(item);
+		}
+		catch (...)
+		{
+			slabs_.release(size_class, offset);
+			items_.release(item);
+			throw;
+		}
+		recency_[size_class].push_most_recent(*item);
+		return true;
+	}
+
+	//O(value size)
+	//reads the value out of its chunk and forgets it, false if key isn't stored
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	template <typename TLookup>
+	bool MyMappedCacheTier<TKey, TValue, TValueSerializer>::take(const TLookup& key, TValue& out_value)
+	{
+		Item** got = key_to_item_.find(key);
+		if (got == nullptr)
+		{
+			return false;
+		}
+		out_value = read_item(**got);
+		erase_item(**got);
+		return true;
+	}
+
+	//O(value size)
+	//reads the value out of its chunk and leaves it stored, it isn't counted as a use
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	template <typename TLookup>
+	std::optional<TValue> MyMappedCacheTier<TKey, TValue, TValueSerializer>::read(const TLookup& key) const
+	{
+		Item* const* got = key_to_item_.find(key);
+		if (got == nullptr)
+		{
+			return std::nullopt;
+		}
+		return read_item(**got);
+	}
+
+	//O(value size)
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	TValue MyMappedCacheTier<TKey, TValue, TValueSerializer>::read_item(const Item& item) const
+	{
+		ByteSource source(file_.data() + item.offset, item.length);
+		std::istream in(&source);
+		return TValueSerializer::read(in);
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	template <typename TLookup>
+	bool MyMappedCacheTier<TKey, TValue, TValueSerializer>::contains(const TLookup& key) const
+	{
+		return key_to_item_.contains(key);
+	}
+
+	//O(1)
+	//returns false if key wasn't stored
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	template <typename TLookup>
+	bool MyMappedCacheTier<TKey, TValue, TValueSerializer>::remove(const TLookup& key)
+	{
+		Item** got = key_to_item_.find(key);
+		if (got == nullptr)
+		{
+			return false;
+		}
+		erase_item(**got);
+		return true;
+	}
+
+	//O(n)
+	//the file keeps its pages, the slabs are handed out afresh
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	void MyMappedCacheTier<TKey, TValue, TValueSerializer>::clear()
+	{
+		key_to_item_.for_each([this](Item* item) { items_.release(item); });
+		key_to_item_.clear();
+		for (IntrusiveList<Item>& list : recency_)
+		{
+			list.clear();
+		}
+		slabs_.clear();
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	size_t MyMappedCacheTier<TKey, TValue, TValueSerializer>::size() const
+	{
+		return key_to_item_.size();
+	}
+
+	//O(1)
+	//in bytes, the part of the file the slabs can use
+	template <typename TKey, typename TValue, typename TValueSerializer>
+	size_t MyMappedCacheTier<TKey, TValue, TValueSerializer>::get_capacity() const
+	{
+		return slabs_.get_page_count() * SLAB_PAGE_SIZE;
+	}
+}
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "MyMappedFile.h"
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ds
+{
+	//O(1)
+	//creates or truncates the file at path, the pages are only given disk blocks as they are written
+	MyMappedFile::MyMappedFile(const std::string& path, size_t size) : size_(size)
+	{
+		if (size == 0)
+		{
+			throw std::exception("mapped file needs a size");
+		}
+#if defined(_WIN32)
+		const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+			FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			throw std::exception("could not create mapped file");
+		}
+		file_ = file;
+		const uint64_t bytes = size;
+		mapping_ = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(bytes >> 32), static_cast<DWORD>(bytes), nullptr);
+		if (mapping_ == nullptr)
+		{
+			close();
+			throw std::exception("could not map file");
+		}
+		data_ = static_cast<char*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size));
+#else
+		file_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (file_ < 0)
+		{
+			throw std::exception("could not create mapped file");
+		}
+		::unlink(path.c_str()); //the open descriptor keeps it alive, nothing is left behind after a crash
+		if (::ftruncate(file_, static_cast<off_t>(size)) != 0)
+		{
+			close();
+			throw std::exception("could not map file");
+		}
+		void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+		data_ = mapped == MAP_FAILED ? nullptr : static_cast<char*>(mapped);
+		if (data_ != nullptr)
+		{
+			::madvise(data_, size, MADV_RANDOM); //lookups are scattered, read ahead would only evict useful pages
+		}
+#endif
+		if (data_ == nullptr)
+		{
+			close();
+			throw std::exception("could not map file");
+		}
+	}
+
+	MyMappedFile::~MyMappedFile()
+	{
+		close();
+	}
+
+	//O(size) for the pages still dirty
+	void MyMappedFile::close()
+	{
+#if defined(_WIN32)
+		if (data_ != nullptr)
+		{
+			UnmapViewOfFile(data_);
+		}
+		if (mapping_ != nullptr)
+		{
+			CloseHandle(mapping_);
+		}
+		if (file_ != nullptr)
+		{
+			CloseHandle(file_);
+		}
+		mapping_ = nullptr;
+		file_ = nullptr;
+#else
+		if (data_ != nullptr)
+		{
+			::munmap(data_, size_);
+		}
+		if (file_ >= 0)
+		{
+			::close(file_);
+		}
+		file_ = -1;
+#endif
+		data_ = nullptr;
+	}
+
+	//O(1)
+	char* MyMappedFile::data()
+	{
+		return data_;
+	}
+
+	//O(1)
+	const char* MyMappedFile::data() const
+	{
+		return data_;
+	}
+
+	//O(1)
+	size_t MyMappedFile::size() const
+	{
+		return size_;
+	}
+}
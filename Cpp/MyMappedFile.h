@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace ds
+{
+	//a scratch file of a fixed size mapped read/write into memory, reads and writes go through the page cache
+	//and only fault a page in from disk the first time it is touched after being dropped
+	//the file is removed once it is closed, it backs a cache and isn't meant to outlive the process
+	class MyMappedFile
+	{
+		char* data_ = nullptr;
+		size_t size_ = 0;
+#if defined(_WIN32)
+		void* file_ = nullptr; //HANDLEs, kept as void* so windows.h stays out of the header
+		void* mapping_ = nullptr;
+#else
+		int file_ = -1;
+#endif
+
+		void close();
+
+	public:
+		MyMappedFile(const std::string& path, size_t size);
+		MyMappedFile(const MyMappedFile&) = delete;
+		MyMappedFile& operator=(const MyMappedFile&) = delete;
+		~MyMappedFile();
+
+		[[nodiscard]] char* data();
+		[[nodiscard]] const char* data() const;
+		[[nodiscard]] size_t size() const;
+	};
+}
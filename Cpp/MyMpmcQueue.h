@@ -0,0 +1,468 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "Interfaces.h"
+
+namespace ds
+{
+	//a bounded lock free queue any number of threads can offer to and poll from at once, Dmitry Vyukov's design
+	//every cell carries a sequence number that says whose turn it is, at position p a cell is free for the producer
+	//that claims p when its sequence is p and holds an item for the consumer that claims p when it is p + 1,
+	//the consumer then hands it to the producer one lap on by setting it to p + capacity
+	//a producer or consumer claims its position with one compare exchange on tail_ or head_, each on its own cache line,
+	//and then only touches its own cell, so producers only contend with producers and consumers with consumers
+	//
+	//offer throws when full and poll when empty, try_offer and try_poll report it instead
+	//poll moves the item into a holder kept by the queue and hands back a reference to it, the reference and the item
+	//last only until the next poll or until the queue goes, so poll is for one consumer at a time, like the IQueue
+	//interface it serves, consumers running together use try_poll
+	//peek_first reads the head cell in place and get_count is a snapshot, both are only exact while nobody else polls
+	template<typename Type>
+	class MyMpmcQueue final : public IQueue<Type>
+	{
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			alignas(Type) unsigned char storage[sizeof(Type)];
+
+			Type& item() { return *std::launder(reinterpret_cast<Type*>(storage)); }
+		};
+
+		template<typename> friend class MyBlockingMpmcQueue;
+
+		Cell* cells_;
+		size_t mask_;
+		std::optional<Type> polled_; //the item poll last handed out a reference to
+		alignas(64) std::atomic<size_t> tail_ = 0;
+		alignas(64) std::atomic<size_t> head_ = 0; //the alignment rounds the queue's size up, so nothing shares this line
+
+		Cell* claim_for_offer(size_t& out_position);
+		Cell* claim_for_poll(size_t& out_position);
+		bool try_poll_into(std::optional<Type>& out_item);
+
+	public:
+		explicit MyMpmcQueue(size_t capacity);
+		MyMpmcQueue(const MyMpmcQueue&) = delete;
+		MyMpmcQueue& operator=(const MyMpmcQueue&) = delete;
+		~MyMpmcQueue() override;
+
+		void offer(const Type&) override;
+		const Type& poll() override;
+		const Type& peek_first() override;
+		int get_count() override;
+
+		bool try_offer(const Type& item);
+		bool try_offer(Type&& item);
+		template<typename... TArgs>
+		bool try_emplace(TArgs&&... args);
+		bool try_poll(Type& out_item);
+
+		[[nodiscard]] size_t get_capacity() const;
+	};
+
+	//O(n)
+	//capacity is rounded up to a power of two, and to at least 2 so a cell's full and free sequences differ
+	template <typename Type>
+	MyMpmcQueue<Type>::MyMpmcQueue(size_t capacity)
+	{
+		if (capacity == 0)
+		{
+			throw std::exception("queue needs a capacity");
+		}
+		size_t rounded = 2;
+		while (rounded < capacity)
+		{
+			rounded *= 2;
+		}
+		mask_ = rounded - 1;
+		cells_ = new Cell[rounded];
+		for (size_t index = 0; index < rounded; index++)
+		{
+			cells_[index].sequence.store(index, std::memory_order_relaxed);
+		}
+	}
+
+	//O(n)
+	//no other thread may still be using the queue
+	template <typename Type>
+	MyMpmcQueue<Type>::~MyMpmcQueue()
+	{
+		if constexpr (!std::is_trivially_destructible_v<Type>)
+		{
+			const size_t tail = tail_.load(std::memory_order_acquire);
+			for (size_t position = head_.load(std::memory_order_relaxed); position != tail; position++)
+			{
+				cells_[position & mask_].item().~Type();
+			}
+		}
+		delete[] cells_;
+	}
+
+	//O(1) uncontended
+	//the cell at the claimed position, ready to build an item in, or nullptr when the queue is full
+	template <typename Type>
+	typename MyMpmcQueue<Type>::Cell* MyMpmcQueue<Type>::claim_for_offer(size_t& out_position)
+	{
+		size_t position = tail_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = cells_[position & mask_];
+			const intptr_t lag = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+			if (lag == 0)
+			{
+				//a failed exchange reloads position, so the loop goes again with whatever the winner left
+				if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					out_position = position;
+					return &cell;
+				}
+			}
+			else if (lag < 0)
+			{
+				return nullptr; //the consumer a lap behind hasn't freed the cell yet
+			}
+			else
+			{
+				position = tail_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//O(1) uncontended
+	//the cell at the claimed position, holding its item, or nullptr when the queue is empty
+	template <typename Type>
+	typename MyMpmcQueue<Type>::Cell* MyMpmcQueue<Type>::claim_for_poll(size_t& out_position)
+	{
+		size_t position = head_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = cells_[position & mask_];
+			const intptr_t lag = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position + 1);
+			if (lag == 0)
+			{
+				if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					out_position = position;
+					return &cell;
+				}
+			}
+			else if (lag < 0)
+			{
+				return nullptr; //the producer hasn't published the cell yet
+			}
+			else
+			{
+				position = head_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//O(1) uncontended
+	//false when the queue is full, the arguments are left alone then
+	//except that a claimed cell has to be published, so a type that might throw while being built is built first and
+	//then moved into its cell, and rvalue arguments to it are used up even when the queue turns out to be full
+	template <typename Type>
+	template <typename... TArgs>
+	bool MyMpmcQueue<Type>::try_emplace(TArgs&&... args)
+	{
+		size_t position = 0;
+		Cell* cell = nullptr;
+		if constexpr (std::is_nothrow_constructible_v<Type, TArgs&&...>)
+		{
+			cell = claim_for_offer(position);
+			if (cell == nullptr)
+			{
+				return false;
+			}
+			new (cell->storage) Type(std::forward<TArgs>(args)...);
+		}
+		else
+		{
+			Type item(std::forward<TArgs>(args)...);
+			cell = claim_for_offer(position);
+			if (cell == nullptr)
+			{
+				return false;
+			}
+			new (cell->storage) Type(std::move(item));
+		}
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	//O(1) uncontended
+	template <typename Type>
+	bool MyMpmcQueue<Type>::try_offer(const Type& item)
+	{
+		return try_emplace(item);
+	}
+
+	//O(1) uncontended
+	template <typename Type>
+	bool MyMpmcQueue<Type>::try_offer(Type&& item)
+	{
+		return try_emplace(std::move(item));
+	}
+
+	//O(1) uncontended
+	//false when the queue is empty
+	template <typename Type>
+	bool MyMpmcQueue<Type>::try_poll(Type& out_item)
+	{
+		size_t position = 0;
+		Cell* cell = claim_for_poll(position);
+		if (cell == nullptr)
+		{
+			return false;
+		}
+		Type& item = cell->item();
+		out_item = std::move(item);
+		item.~Type();
+		cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+
+	//O(1) uncontended
+	//like try_poll but move constructs the item into out_item, so Type needn't be default constructible
+	template <typename Type>
+	bool MyMpmcQueue<Type>::try_poll_into(std::optional<Type>& out_item)
+	{
+		size_t position = 0;
+		Cell* cell = claim_for_poll(position);
+		if (cell == nullptr)
+		{
+			return false;
+		}
+		Type& item = cell->item();
+		out_item.emplace(std::move(item));
+		item.~Type();
+		cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+
+	//O(1) uncontended
+	template <typename Type>
+	void MyMpmcQueue<Type>::offer(const Type& item)
+	{
+		if (!try_emplace(item)) throw std::exception("full queue");
+	}
+
+	//O(1) uncontended
+	//one consumer at a time, the reference is good until the next poll
+	template <typename Type>
+	const Type& MyMpmcQueue<Type>::poll()
+	{
+		if (!try_poll_into(polled_)) throw std::exception("empty queue");
+		return *polled_;
+	}
+
+	//O(1)
+	template <typename Type>
+	const Type& MyMpmcQueue<Type>::peek_first()
+	{
+		const size_t position = head_.load(std::memory_order_acquire);
+		Cell& cell = cells_[position & mask_];
+		if (cell.sequence.load(std::memory_order_acquire) != position + 1) throw std::exception("empty queue");
+		return cell.item();
+	}
+
+	//O(1)
+	template <typename Type>
+	int MyMpmcQueue<Type>::get_count()
+	{
+		const size_t head = head_.load(std::memory_order_acquire);
+		const size_t tail = tail_.load(std::memory_order_acquire);
+		return tail > head ? static_cast<int>(tail - head) : 0;
+	}
+
+	//O(1)
+	template <typename Type>
+	size_t MyMpmcQueue<Type>::get_capacity() const
+	{
+		return mask_ + 1;
+	}
+
+	//a MyMpmcQueue whose offer waits while it is full and whose poll waits while it is empty
+	//a waiting thread first retries for SPIN_TRIES rounds, yielding between them, which is all a busy queue needs,
+	//and only then parks on a condition variable, the other side only takes the lock to wake it when the parked
+	//count says someone is waiting, so while nobody is parked the wrapper adds a fence and a load per call
+	//poll keeps the item in a holder of its own like MyMpmcQueue::poll, so it is for one consumer at a time and the
+	//reference lasts until the next poll, take hands the item over and suits any number of consumers
+	template<typename Type>
+	class MyBlockingMpmcQueue final : public IQueue<Type>
+	{
+		static constexpr int SPIN_TRIES = 64;
+
+		MyMpmcQueue<Type> queue_;
+		std::mutex mutex_;
+		std::condition_variable not_empty_;
+		std::condition_variable not_full_;
+		std::atomic<int> parked_pollers_ = 0;
+		std::atomic<int> parked_offerers_ = 0;
+		std::optional<Type> polled_; //the item poll last handed out a reference to
+
+		template<typename TTry>
+		void wait_until(TTry try_once, std::atomic<int>& parked, std::condition_variable& wake);
+		void wake_one(std::atomic<int>& parked, std::condition_variable& wake);
+
+	public:
+		explicit MyBlockingMpmcQueue(size_t capacity);
+
+		void offer(const Type&) override;
+		void offer(Type&& item);
+		const Type& poll() override;
+		Type take();
+		const Type& peek_first() override;
+		int get_count() override;
+
+		bool try_offer(const Type& item);
+		bool try_offer(Type&& item);
+		bool try_poll(Type& out_item);
+
+		[[nodiscard]] size_t get_capacity() const;
+	};
+
+	//O(n)
+	template <typename Type>
+	MyBlockingMpmcQueue<Type>::MyBlockingMpmcQueue(size_t capacity) : queue_(capacity) {}
+
+	//spins, then parks until try_once succeeds
+	//parked is raised before the last try under the lock, and the waker reads it after its own change with a fence
+	//between, so either that try sees the change or the waker sees parked and notifies, which it can't do before
+	//this thread is waiting since it takes the lock to notify
+	template <typename Type>
+	template <typename TTry>
+	void MyBlockingMpmcQueue<Type>::wait_until(TTry try_once, std::atomic<int>& parked, std::condition_variable& wake)
+	{
+		for (int spin = 0; spin < SPIN_TRIES; spin++)
+		{
+			if (try_once())
+			{
+				return;
+			}
+			std::this_thread::yield();
+		}
+
+		parked.fetch_add(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::unique_lock lock(mutex_);
+		while (!try_once())
+		{
+			wake.wait(lock);
+		}
+		parked.fetch_sub(1);
+	}
+
+	template <typename Type>
+	void MyBlockingMpmcQueue<Type>::wake_one(std::atomic<int>& parked, std::condition_variable& wake)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (parked.load(std::memory_order_relaxed) == 0)
+		{
+			return;
+		}
+		{
+			std::lock_guard lock(mutex_);
+		}
+		wake.notify_one();
+	}
+
+	//O(1) unless it has to wait
+	template <typename Type>
+	void MyBlockingMpmcQueue<Type>::offer(const Type& item)
+	{
+		wait_until([&] { return queue_.try_offer(item); }, parked_offerers_, not_full_);
+		wake_one(parked_pollers_, not_empty_);
+	}
+
+	//O(1) unless it has to wait
+	//item is only moved from once there is room, a type whose move might throw is copied in instead
+	template <typename Type>
+	void MyBlockingMpmcQueue<Type>::offer(Type&& item)
+	{
+		if constexpr (std::is_nothrow_move_constructible_v<Type>)
+		{
+			wait_until([&] { return queue_.try_offer(std::move(item)); }, parked_offerers_, not_full_);
+			wake_one(parked_pollers_, not_empty_);
+		}
+		else
+		{
+			offer(static_cast<const Type&>(item));
+		}
+	}
+
+	//O(1) unless it has to wait
+	template <typename Type>
+	Type MyBlockingMpmcQueue<Type>::take()
+	{
+		std::optional<Type> taken;
+		wait_until([&] { return queue_.try_poll_into(taken); }, parked_pollers_, not_empty_);
+		wake_one(parked_offerers_, not_full_);
+		return std::move(*taken);
+	}
+
+	//O(1) unless it has to wait
+	//one consumer at a time, the reference is good until the next poll
+	template <typename Type>
+	const Type& MyBlockingMpmcQueue<Type>::poll()
+	{
+		polled_.emplace(take());
+		return *polled_;
+	}
+
+	//O(1)
+	//doesn't wait, throws when empty like MyMpmcQueue::peek_first
+	template <typename Type>
+	const Type& MyBlockingMpmcQueue<Type>::peek_first()
+	{
+		return queue_.peek_first();
+	}
+
+	//O(1)
+	template <typename Type>
+	int MyBlockingMpmcQueue<Type>::get_count()
+	{
+		return queue_.get_count();
+	}
+
+	//O(1) uncontended
+	template <typename Type>
+	bool MyBlockingMpmcQueue<Type>::try_offer(const Type& item)
+	{
+		if (!queue_.try_offer(item)) return false;
+		wake_one(parked_pollers_, not_empty_);
+		return true;
+	}
+
+	//O(1) uncontended
+	template <typename Type>
+	bool MyBlockingMpmcQueue<Type>::try_offer(Type&& item)
+	{
+		if (!queue_.try_offer(std::move(item))) return false;
+		wake_one(parked_pollers_, not_empty_);
+		return true;
+	}
+
+	//O(1) uncontended
+	template <typename Type>
+	bool MyBlockingMpmcQueue<Type>::try_poll(Type& out_item)
+	{
+		if (!queue_.try_poll(out_item)) return false;
+		wake_one(parked_offerers_, not_full_);
+		return true;
+	}
+
+	//O(1)
+	template <typename Type>
+	size_t MyBlockingMpmcQueue<Type>::get_capacity() const
+	{
+		return queue_.get_capacity();
+	}
+}
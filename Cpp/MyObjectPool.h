@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ds
+{
+	//hands out objects from chunks of slots with a free list threaded through the unused ones,
+	//so each object costs exactly its own size with no allocator header, and addresses never move
+	//chunks double in size up to MAX_CHUNK slots and are only given back when the pool goes
+	//the pool doesn't track which slots are in use, objects still alive when it is destroyed aren't destroyed
+	template<typename T>
+	class MyObjectPool
+	{
+		union Slot
+		{
+			Slot* next_free;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		static constexpr size_t FIRST_CHUNK = 16;
+		static constexpr size_t MAX_CHUNK = 1024;
+
+		std::vector<std::unique_ptr<Slot[]>> chunks_;
+		Slot* free_ = nullptr;
+		size_t next_chunk_ = FIRST_CHUNK;
+		size_t slot_count_ = 0;
+		size_t size_ = 0;
+
+		void grow();
+
+	public:
+		MyObjectPool() = default;
+		MyObjectPool(const MyObjectPool&) = delete;
+		MyObjectPool& operator=(const MyObjectPool&) = delete;
+
+		template<typename... TArgs>
+		T* make(TArgs&&... args);
+		void release(T* object);
+		size_t size() const;
+		size_t allocated_bytes() const;
+	};
+
+	//O(chunk)
+	template <typename T>
+	void MyObjectPool<T>::grow()
+	{
+		chunks_.push_back(std::make_unique<Slot[]>(next_chunk_));
+		Slot* chunk = chunks_.back().get();
+		for (size_t index = 0; index < next_chunk_; index++)
+		{
+			chunk[index].next_free = index + 1 < next_chunk_ ? &chunk[index + 1] : free_;
+		}
+		free_ = chunk;
+		slot_count_ += next_chunk_;
+		next_chunk_ = std::min(next_chunk_ * 2, MAX_CHUNK);
+	}
+
+	//O(1) amortised
+	//builds a T from args in a free slot, the slot goes back on the free list if the constructor throws
+	template <typename T>
+	template <typename... TArgs>
+	T* MyObjectPool<T>::make(TArgs&&... args)
+	{
+		if (free_ == nullptr)
+		{
+			grow();
+		}
+		Slot* slot = free_;
+		free_ = slot->next_free;
+		try
+		{
+			T* object = new (slot->storage) T(std::forward<TArgs>(args)...);
+			++size_;
+			return object;
+		}
+		catch (...)
+		{
+			slot->next_free = free_;
+			free_ = slot;
+			throw;
+		}
+	}
+
+	//O(1)
+	//destroys the object and keeps its slot for the next make
+	template <typename T>
+	void MyObjectPool<T>::release(T* object)
+	{
+		object->~T();
+		Slot* slot = reinterpret_cast<Slot*>(object);
+		slot->next_free = free_;
+		free_ = slot;
+		--size_;
+	}
+
+	//O(1)
+	template <typename T>
+	size_t MyObjectPool<T>::size() const
+	{
+		return size_;
+	}
+
+	//O(1)
+	template <typename T>
+	size_t MyObjectPool<T>::allocated_bytes() const
+	{
+		return slot_count_ * sizeof(Slot);
+	}
+}
@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "MySlabAllocator.h"
+
+#include <algorithm>
+
+namespace ds
+{
+	//O(classes)
+	//bytes is rounded down to whole pages, and has to hold at least one
+	MySlabAllocator::MySlabAllocator(size_t bytes) : page_count_(bytes / SLAB_PAGE_SIZE)
+	{
+		if (page_count_ == 0)
+		{
+			throw std::exception("slab allocator needs at least one page");
+		}
+		for (size_t chunk = SLAB_MIN_CHUNK; chunk <= SLAB_PAGE_SIZE / 2; chunk = (chunk + chunk / 4 + 7) & ~static_cast<size_t>(7))
+		{
+			classes_.push_back(SizeClass{ chunk, {}, 0, 0 });
+		}
+		classes_.push_back(SizeClass{ SLAB_PAGE_SIZE, {}, 0, 0 });
+	}
+
+	//O(log classes)
+	//the smallest class whose chunks hold bytes, -1 when bytes is more than a page
+	int MySlabAllocator::class_for(size_t bytes) const
+	{
+		auto found = std::lower_bound(classes_.begin(), classes_.end(), bytes,
+			[](const SizeClass& size_class, size_t wanted) { return size_class.chunk_size < wanted; });
+		return found == classes_.end() ? -1 : static_cast<int>(found - classes_.begin());
+	}
+
+	//O(1)
+	size_t MySlabAllocator::chunk_size(int size_class) const
+	{
+		return classes_[size_class].chunk_size;
+	}
+
+	//O(1)
+	size_t MySlabAllocator::class_count() const
+	{
+		return classes_.size();
+	}
+
+	//O(1)
+	//false when the class has no free chunk and every page is taken, out_offset is left alone then
+	bool MySlabAllocator::allocate(int size_class, uint64_t& out_offset)
+	{
+		SizeClass& chosen = classes_[size_class];
+		if (!chosen.free.empty())
+		{
+			out_offset = chosen.free.back();
+			chosen.free.pop_back();
+			return true;
+		}
+		if (chosen.carve_next == chosen.carve_end)
+		{
+			if (pages_used_ == page_count_)
+			{
+				return false;
+			}
+			chosen.carve_next = static_cast<uint64_t>(pages_used_) * SLAB_PAGE_SIZE;
+			chosen.carve_end = chosen.carve_next + SLAB_PAGE_SIZE / chosen.chunk_size * chosen.chunk_size;
+			++pages_used_;
+		}
+		out_offset = chosen.carve_next;
+		chosen.carve_next += chosen.chunk_size;
+		return true;
+	}
+
+	//O(1) amortised
+	//the chunk has to have come from allocate for the same class
+	void MySlabAllocator::release(int size_class, uint64_t offset)
+	{
+		classes_[size_class].free.push_back(offset);
+	}
+
+	//O(classes + released chunks)
+	//every page goes back unassigned
+	void MySlabAllocator::clear()
+	{
+		for (SizeClass& size_class : classes_)
+		{
+			size_class.free.clear();
+			size_class.carve_next = 0;
+			size_class.carve_end = 0;
+		}
+		pages_used_ = 0;
+	}
+
+	//O(1)
+	size_t MySlabAllocator::get_page_count() const
+	{
+		return page_count_;
+	}
+
+	//O(1)
+	size_t MySlabAllocator::get_pages_used() const
+	{
+		return pages_used_;
+	}
+}
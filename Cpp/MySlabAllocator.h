@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace ds
+{
+	//hands out chunks of a fixed byte range the way memcached's slabs do, the range is cut into pages of
+	//SLAB_PAGE_SIZE and a page is given to a size class the first time that class runs out of chunks,
+	//every chunk of a class is the same size so a freed chunk is reused as is and the range never fragments
+	//chunk sizes grow by a quarter from SLAB_MIN_CHUNK, wasting at most a fifth of a chunk, the largest is a page
+	//
+	//the allocator only hands out offsets, it never touches the memory, once every page has a class a class
+	//that is out of chunks stays out until one of its own chunks is released
+	constexpr size_t SLAB_PAGE_SIZE = 1 << 20;
+	constexpr size_t SLAB_MIN_CHUNK = 64;
+
+	class MySlabAllocator
+	{
+		struct SizeClass
+		{
+			size_t chunk_size;
+			std::vector<uint64_t> free; //released chunks, reused before carving more of the class's last page
+			uint64_t carve_next = 0;
+			uint64_t carve_end = 0;
+		};
+
+		std::vector<SizeClass> classes_;
+		size_t page_count_;
+		size_t pages_used_ = 0;
+
+	public:
+		explicit MySlabAllocator(size_t bytes);
+
+		[[nodiscard]] int class_for(size_t bytes) const;
+		[[nodiscard]] size_t chunk_size(int size_class) const;
+		[[nodiscard]] size_t class_count() const;
+		bool allocate(int size_class, uint64_t& out_offset);
+		void release(int size_class, uint64_t offset);
+		void clear();
+
+		[[nodiscard]] size_t get_page_count() const;
+		[[nodiscard]] size_t get_pages_used() const;
+	};
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ds
+{
+	//a bounded lock free ring for handing items from exactly one producer thread to exactly one consumer thread
+	//laid out like MyArrayDeque, a power of two of raw slots indexed with a mask, only live items are constructed
+	//
+	//tail_ counts every item ever pushed and head_ every item ever popped, so tail_ - head_ is the count and the
+	//slot is the count masked, each is written by one side only and published with a release store
+	//each side keeps its own copy of the other side's index and only reloads it when the copy says the ring is
+	//full or empty, so in steady state neither side reads the other's cache line on every operation
+	//the two sides live on separate cache lines so a push never invalidates the line the consumer is polling
+	template<typename Type>
+	class MySpscRingBuffer
+	{
+		struct alignas(64) ProducerSide
+		{
+			std::atomic<size_t> tail = 0;
+			size_t cached_head = 0;
+		};
+
+		struct alignas(64) ConsumerSide
+		{
+			std::atomic<size_t> head = 0;
+			size_t cached_tail = 0;
+		};
+
+		Type* slots_;
+		size_t capacity_;
+		size_t mask_;
+		ProducerSide producer_;
+		ConsumerSide consumer_;
+
+		size_t free_slots(size_t count);
+		size_t ready_items(size_t count);
+		static void copy_run(const Type* items, size_t count, Type* destination);
+		static void move_run(Type* items, size_t count, Type* out_items);
+
+	public:
+		explicit MySpscRingBuffer(size_t capacity);
+		MySpscRingBuffer(const MySpscRingBuffer&) = delete;
+		MySpscRingBuffer& operator=(const MySpscRingBuffer&) = delete;
+		~MySpscRingBuffer();
+
+		//producer only
+		bool try_push(const Type& item);
+		bool try_push(Type&& item);
+		template<typename... TArgs>
+		bool try_emplace(TArgs&&... args);
+		size_t try_push_n(const Type* items, size_t count);
+
+		//consumer only
+		bool try_pop(Type& out_item);
+		size_t try_pop_n(Type* out_items, size_t count);
+
+		[[nodiscard]] size_t get_count() const;
+		[[nodiscard]] size_t get_capacity() const;
+	};
+
+	//O(1)
+	//capacity is rounded up to a power of two
+	template <typename Type>
+	MySpscRingBuffer<Type>::MySpscRingBuffer(size_t capacity)
+	{
+		if (capacity == 0)
+		{
+			throw std::exception("ring buffer needs a capacity");
+		}
+		capacity_ = 1;
+		while (capacity_ < capacity)
+		{
+			capacity_ *= 2;
+		}
+		mask_ = capacity_ - 1;
+		slots_ = std::allocator<Type>().allocate(capacity_);
+	}
+
+	//O(n)
+	//neither side may still be running
+	template <typename Type>
+	MySpscRingBuffer<Type>::~MySpscRingBuffer()
+	{
+		if constexpr (!std::is_trivially_destructible_v<Type>)
+		{
+			const size_t tail = producer_.tail.load(std::memory_order_acquire);
+			for (size_t index = consumer_.head.load(std::memory_order_relaxed); index != tail; index++)
+			{
+				slots_[index & mask_].~Type();
+			}
+		}
+		std::allocator<Type>().deallocate(slots_, capacity_);
+	}
+
+	//O(1)
+	//how many of count items the producer can push, reloading the consumer's head only when the cached one
+	//doesn't leave room for all of them
+	template <typename Type>
+	size_t MySpscRingBuffer<Type>::free_slots(size_t count)
+	{
+		const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+		size_t free = capacity_ - (tail - producer_.cached_head);
+		if (free < count)
+		{
+			producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+			free = capacity_ - (tail - producer_.cached_head);
+		}
+		return std::min(free, count);
+	}
+
+	//O(1)
+	//how many of count items the consumer can pop, the same as free_slots the other way round
+	template <typename Type>
+	size_t MySpscRingBuffer<Type>::ready_items(size_t count)
+	{
+		const size_t head = consumer_.head.load(std::memory_order_relaxed);
+		size_t ready = consumer_.cached_tail - head;
+		if (ready < count)
+		{
+			consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+			ready = consumer_.cached_tail - head;
+		}
+		return std::min(ready, count);
+	}
+
+	//O(count)
+	//copy constructs count items into raw slots
+	template <typename Type>
+	void MySpscRingBuffer<Type>::copy_run(const Type* items, size_t count, Type* destination)
+	{
+		if constexpr (std::is_trivially_copyable_v<Type>)
+		{
+			std::memcpy(destination, items, sizeof(Type) * count);
+		}
+		else
+		{
+			std::uninitialized_copy_n(items, count, destination);
+		}
+	}
+
+	//O(count)
+	//moves count items out and leaves their slots raw
+	template <typename Type>
+	void MySpscRingBuffer<Type>::move_run(Type* items, size_t count, Type* out_items)
+	{
+		if constexpr (std::is_trivially_copyable_v<Type>)
+		{
+			std::memcpy(out_items, items, sizeof(Type) * count);
+		}
+		else
+		{
+			std::move(items, items + count, out_items);
+			std::destroy(items, items + count);
+		}
+	}
+
+	//O(1)
+	template <typename Type>
+	bool MySpscRingBuffer<Type>::try_push(const Type& item)
+	{
+		return try_emplace(item);
+	}
+
+	//O(1)
+	template <typename Type>
+	bool MySpscRingBuffer<Type>::try_push(Type&& item)
+	{
+		return try_emplace(std::move(item));
+	}
+
+	//O(1)
+	//false when the ring is full, the arguments are left alone then
+	template <typename Type>
+	template <typename... TArgs>
+	bool MySpscRingBuffer<Type>::try_emplace(TArgs&&... args)
+	{
+		if (free_slots(1) == 0)
+		{
+			return false;
+		}
+		const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+		new (&slots_[tail & mask_]) Type(std::forward<TArgs>(args)...);
+		producer_.tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	//O(count)
+	//pushes as many of the items as fit, in order, and returns how many that was
+	//the batch is published with one store, trivially copyable items go in with at most two memcpys
+	//if a copy throws nothing is pushed, the copies already made are destroyed before it propagates
+	template <typename Type>
+	size_t MySpscRingBuffer<Type>::try_push_n(const Type* items, size_t count)
+	{
+		const size_t pushed = free_slots(count);
+		const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+		const size_t first_run = std::min(pushed, capacity_ - (tail & mask_));
+		copy_run(items, first_run, slots_ + (tail & mask_)); //a run that throws cleans up after itself
+		try
+		{
+			copy_run(items + first_run, pushed - first_run, slots_);
+		}
+		catch (...)
+		{
+			std::destroy(slots_ + (tail & mask_), slots_ + (tail & mask_) + first_run);
+			throw;
+		}
+		producer_.tail.store(tail + pushed, std::memory_order_release);
+		return pushed;
+	}
+
+	//O(1)
+	//false when the ring is empty
+	template <typename Type>
+	bool MySpscRingBuffer<Type>::try_pop(Type& out_item)
+	{
+		if (ready_items(1) == 0)
+		{
+			return false;
+		}
+		const size_t head = consumer_.head.load(std::memory_order_relaxed);
+		Type& slot = slots_[head & mask_];
+		out_item = std::move(slot);
+		slot.~Type();
+		consumer_.head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	//O(count)
+	//moves up to count items into out_items, which must hold count constructed items, and returns how many
+	template <typename Type>
+	size_t MySpscRingBuffer<Type>::try_pop_n(Type* out_items, size_t count)
+	{
+		const size_t popped = ready_items(count);
+		const size_t head = consumer_.head.load(std::memory_order_relaxed);
+		const size_t first_run = std::min(popped, capacity_ - (head & mask_));
+		move_run(slots_ + (head & mask_), first_run, out_items);
+		move_run(slots_, popped - first_run, out_items + first_run);
+		consumer_.head.store(head + popped, std::memory_order_release);
+		return popped;
+	}
+
+	//O(1)
+	//only a snapshot while either side is running
+	template <typename Type>
+	size_t MySpscRingBuffer<Type>::get_count() const
+	{
+		const size_t head = consumer_.head.load(std::memory_order_acquire);
+		return producer_.tail.load(std::memory_order_acquire) - head;
+	}
+
+	//O(1)
+	template <typename Type>
+	size_t MySpscRingBuffer<Type>::get_capacity() const
+	{
+		return capacity_;
+	}
+}
@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "MyThreadPool.h"
+
+#include <algorithm>
+
+namespace ds
+{
+	thread_local MyThreadPool::Worker* MyThreadPool::current_worker_ = nullptr;
+
+	//O(1)
+	//one worker per hardware thread
+	MyThreadPool::MyThreadPool() : MyThreadPool(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+	{
+	}
+
+	//O(thread_count)
+	MyThreadPool::MyThreadPool(int thread_count)
+	{
+		if (thread_count < 1)
+		{
+			throw std::exception("thread pool needs a thread");
+		}
+		//every deque exists before any worker starts stealing from them
+		for (int index = 0; index < thread_count; index++)
+		{
+			workers_.push_back(std::make_unique<Worker>());
+			workers_.back()->pool = this;
+			workers_.back()->steal_seed = static_cast<uint32_t>(index) * 2654435761u + 1;
+		}
+		for (std::unique_ptr<Worker>& worker : workers_)
+		{
+			worker->thread = std::thread(&MyThreadPool::work, this, worker.get());
+		}
+	}
+
+	//O(thread_count)
+	//runs whatever is still queued, then stops and joins the workers
+	MyThreadPool::~MyThreadPool()
+	{
+		{
+			std::lock_guard lock(sleep_mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		for (std::unique_ptr<Worker>& worker : workers_)
+		{
+			worker->thread.join();
+		}
+	}
+
+	//O(1)
+	//the calling thread's worker if it is one of this pool's
+	MyThreadPool::Worker* MyThreadPool::own_worker() const
+	{
+		return current_worker_ != nullptr && current_worker_->pool == this ? current_worker_ : nullptr;
+	}
+
+	//O(1) amortised
+	//pending_ is raised before the task is visible and sleeping_ read after, a worker going to sleep raises sleeping_
+	//before reading pending_, both sequentially consistent, so one of the two always sees the other
+	void MyThreadPool::enqueue(std::function<void()> work)
+	{
+		Task* task = new Task{ std::move(work) };
+		pending_.fetch_add(1);
+		if (Worker* worker = own_worker())
+		{
+			worker->tasks.push(task);
+		}
+		else
+		{
+			std::lock_guard lock(injected_mutex_);
+			injected_.add_last(task);
+			injected_count_.fetch_add(1, std::memory_order_release);
+		}
+		if (sleeping_.load() > 0)
+		{
+			//a sleeper that has checked pending_ holds the mutex until it waits, so this can't notify too early
+			{
+				std::lock_guard lock(sleep_mutex_);
+			}
+			wake_.notify_one();
+		}
+	}
+
+	//O(thread_count)
+	//the newest task of the worker's own deque, then the oldest injected one, then the oldest of another worker,
+	//starting from a random one so thieves spread out, worker is null for a thread outside the pool
+	MyThreadPool::Task* MyThreadPool::find_task(Worker* worker)
+	{
+		Task* task = nullptr;
+		if (worker != nullptr && worker->tasks.try_pop(task))
+		{
+			pending_.fetch_sub(1, std::memory_order_relaxed);
+			return task;
+		}
+		if (injected_count_.load(std::memory_order_acquire) > 0)
+		{
+			std::lock_guard lock(injected_mutex_);
+			if (injected_.get_count() > 0)
+			{
+				task = injected_.take_first();
+				injected_count_.fetch_sub(1, std::memory_order_relaxed);
+				pending_.fetch_sub(1, std::memory_order_relaxed);
+				return task;
+			}
+		}
+
+		static thread_local uint32_t outsider_seed = 1;
+		uint32_t& seed = worker != nullptr ? worker->steal_seed : outsider_seed;
+		seed ^= seed << 13; //xorshift
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		const size_t count = workers_.size();
+		const size_t start = seed % count;
+		for (size_t offset = 0; offset < count; offset++)
+		{
+			Worker* victim = workers_[(start + offset) % count].get();
+			if (victim != worker && victim->tasks.try_steal(task))
+			{
+				pending_.fetch_sub(1, std::memory_order_relaxed);
+				return task;
+			}
+		}
+		return nullptr;
+	}
+
+	//O(thread_count) plus the task
+	//false when no task could be found
+	bool MyThreadPool::run_one()
+	{
+		Task* task = find_task(own_worker());
+		if (task == nullptr)
+		{
+			return false;
+		}
+		task->work();
+		delete task;
+		return true;
+	}
+
+	//each worker's loop, runs tasks until the pool stops with nothing left pending
+	void MyThreadPool::work(Worker* worker)
+	{
+		current_worker_ = worker;
+		int idle_rounds = 0;
+		while (true)
+		{
+			if (run_one())
+			{
+				idle_rounds = 0;
+				continue;
+			}
+			if (++idle_rounds < IDLE_ROUNDS)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			idle_rounds = 0;
+
+			std::unique_lock lock(sleep_mutex_);
+			sleeping_.fetch_add(1);
+			wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+			sleeping_.fetch_sub(1);
+			if (stopping_ && pending_.load() == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	//O(1)
+	int MyThreadPool::get_thread_count() const
+	{
+		return static_cast<int>(workers_.size());
+	}
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "MyArrayDeque.h"
+#include "MyWorkStealingDeque.h"
+
+namespace ds
+{
+	//a fixed set of worker threads that each own a MyWorkStealingDeque of tasks
+	//a task submitted from a worker goes on that worker's own deque and is popped newest first, while what it
+	//touches is still in cache, an idle worker steals the oldest task of another, which in a fork join graph is the
+	//biggest piece of work left, so workers rarely meet on the same lock or cache line
+	//tasks submitted from outside the pool go through one locked MyArrayDeque the workers also check
+	//a worker that finds nothing yields for a while and then sleeps until something is submitted
+	//
+	//a worker waiting in parallel_for runs tasks while it waits rather than blocking, so parallel_for nests inside
+	//tasks, a task blocking on a future from submit can take a worker out for as long as it waits
+	class MyThreadPool
+	{
+		static constexpr int IDLE_ROUNDS = 64;
+
+		struct Task
+		{
+			std::function<void()> work;
+		};
+
+		struct Worker
+		{
+			MyThreadPool* pool;
+			MyWorkStealingDeque<Task*> tasks;
+			uint32_t steal_seed;
+			std::thread thread;
+		};
+
+		static thread_local Worker* current_worker_;
+
+		std::vector<std::unique_ptr<Worker>> workers_;
+		std::mutex injected_mutex_;
+		MyArrayDeque<Task*> injected_;
+		std::atomic<int64_t> injected_count_ = 0;
+		alignas(64) std::atomic<int64_t> pending_ = 0; //submitted and not yet taken by a thread
+		std::atomic<int> sleeping_ = 0;
+		std::mutex sleep_mutex_;
+		std::condition_variable wake_;
+		bool stopping_ = false; //guarded by sleep_mutex_
+
+		Worker* own_worker() const;
+		void enqueue(std::function<void()> work);
+		Task* find_task(Worker* worker);
+		bool run_one();
+		void work(Worker* worker);
+
+		template<typename TDone>
+		void help_until(TDone done);
+
+	public:
+		MyThreadPool();
+		explicit MyThreadPool(int thread_count);
+		MyThreadPool(const MyThreadPool&) = delete;
+		MyThreadPool& operator=(const MyThreadPool&) = delete;
+		~MyThreadPool();
+
+		template<typename TFunction>
+		auto submit(TFunction function) -> std::future<std::invoke_result_t<TFunction&>>;
+
+		template<typename TBody>
+		void parallel_for(int64_t begin, int64_t end, TBody body, int64_t grain = 1);
+
+		[[nodiscard]] int get_thread_count() const;
+	};
+
+	//runs tasks on the calling thread until done returns true
+	template <typename TDone>
+	void MyThreadPool::help_until(TDone done)
+	{
+		while (!done())
+		{
+			if (!run_one())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	//O(1)
+	//queues function and returns the future of its result, an exception it throws comes out of the future
+	template <typename TFunction>
+	auto MyThreadPool::submit(TFunction function) -> std::future<std::invoke_result_t<TFunction&>>
+	{
+		using Result = std::invoke_result_t<TFunction&>;
+		//std::function needs a copyable target and packaged_task is move only
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+		std::future<Result> result = task->get_future();
+		enqueue([task] { (*task)(); });
+		return result;
+	}
+
+	//O((end - begin) / grain) tasks
+	//calls body(index) for every index in [begin, end) and returns once all have run
+	//the range is halved into tasks until a piece is no bigger than grain, the halves go on the deque of the worker
+	//that split them so thieves take the biggest pieces, a worker calling this works through the range as well
+	//while a thread outside the pool hands the whole range to a worker and blocks
+	//the first exception a body throws is rethrown here once the rest of the range is done
+	template <typename TBody>
+	void MyThreadPool::parallel_for(int64_t begin, int64_t end, TBody body, int64_t grain)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+		if (grain < 1)
+		{
+			throw std::exception("grain has to be at least one");
+		}
+
+		if (own_worker() == nullptr)
+		{
+			//split on a worker, the injected queue is first in first out and a thread outside the pool helping from it
+			//would nest every other branch of the range on its own stack
+			submit([&] { parallel_for(begin, end, std::ref(body), grain); }).get();
+			return;
+		}
+
+		std::atomic<int64_t> remaining = end - begin;
+		std::mutex error_mutex;
+		std::exception_ptr error;
+		std::function<void(int64_t, int64_t)> split = [&](int64_t from, int64_t to)
+		{
+			while (to - from > grain)
+			{
+				const int64_t middle = from + (to - from) / 2;
+				enqueue([&split, middle, to] { split(middle, to); });
+				to = middle;
+			}
+			try
+			{
+				for (int64_t index = from; index < to; index++)
+				{
+					body(index);
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard lock(error_mutex);
+				if (!error) error = std::current_exception();
+			}
+			remaining.fetch_sub(to - from, std::memory_order_acq_rel); //nothing shared is touched after this, the caller may return
+		};
+
+		split(begin, end);
+		help_until([&] { return remaining.load(std::memory_order_acquire) == 0; });
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
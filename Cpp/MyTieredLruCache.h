@@ -0,0 +1,228 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <utility>
+#include "MyLruCache.h"
+#include "MyMappedCacheTier.h"
+
+namespace ds
+{
+	//a MyLruCache in memory with a MyMappedCacheTier behind it, so the cache can hold many times what fits in ram
+	//entries the memory tier evicts for capacity are demoted to the mapped tier through its removal listener,
+	//and a miss in memory that hits the mapped tier promotes the entry back, an entry only ever lives in one tier
+	//
+	//the mapped tier keeps no time to live, so there are no puts with one here
+	//get and try_get return copies since a promotion can evict what a reference would point at
+	template<typename TKey, typename TValue, template<typename> class TPolicy = LruPolicy, typename TStats = NoCacheStats, typename TValueSerializer = SnapshotSerializer<TValue>>
+	class MyTieredLruCache
+	{
+		MyLruCache<TKey, TValue, TPolicy, TStats> memory_;
+		MyMappedCacheTier<TKey, TValue, TValueSerializer> mapped_;
+		size_t promotions_ = 0;
+		size_t demotions_ = 0;
+
+		std::optional<TValue> copy_value(const TKey& key);
+
+	public:
+		MyTieredLruCache(const std::string& path, size_t mapped_bytes);
+		MyTieredLruCache(const MyTieredLruCache&) = delete;
+		MyTieredLruCache& operator=(const MyTieredLruCache&) = delete;
+
+		size_t size();
+		size_t get_memory_size();
+		size_t get_mapped_size() const;
+		size_t get_capacity() const;
+		void set_capacity(size_t capacity);
+		size_t get_promotions() const;
+		size_t get_demotions() const;
+
+		void put(const TKey& key, TValue& value);
+		void put(const TKey& key, TValue&& value);
+		void put(TKey&& key, TValue&& value);
+		TValue get(const TKey& key);
+		bool try_get(const TKey& key, TValue& out_value);
+		void remove(const TKey& key);
+		bool contains(const TKey& key);
+		void clear();
+		CacheStatsSnapshot get_stats() const;
+	};
+
+	//O(1)
+	//mapped_bytes is the size of the tier's backing file, see MyMappedCacheTier
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::MyTieredLruCache(const std::string& path, size_t mapped_bytes)
+		: mapped_(path, mapped_bytes)
+	{
+		memory_.set_removal_listener([this](TKey&& key, TValue&& value, RemovalCause cause)
+		{
+			if (cause == RemovalCause::Capacity && mapped_.put(key, value))
+			{
+				++demotions_;
+			}
+		});
+	}
+
+	//O(1)
+	//both tiers together
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	size_t MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::size()
+	{
+		return memory_.size() + mapped_.size();
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	size_t MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get_memory_size()
+	{
+		return memory_.size();
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	size_t MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get_mapped_size() const
+	{
+		return mapped_.size();
+	}
+
+	//O(1)
+	//of the memory tier, the mapped tier is bounded by its file
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	size_t MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get_capacity() const
+	{
+		return memory_.get_capacity();
+	}
+
+	//O(n) worse case
+	//O(1) best case
+	//entries a smaller capacity pushes out are demoted
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	void MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::set_capacity(size_t capacity)
+	{
+		memory_.set_capacity(capacity);
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	size_t MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get_promotions() const
+	{
+		return promotions_;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	size_t MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get_demotions() const
+	{
+		return demotions_;
+	}
+
+	//O(1) amortised
+	//a stale copy in the mapped tier is dropped first so it can't be promoted over the new value
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	void MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::put(const TKey& key, TValue& value)
+	{
+		mapped_.remove(key);
+		memory_.put(key, value);
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	void MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::put(const TKey& key, TValue&& value)
+	{
+		mapped_.remove(key);
+		memory_.put(key, std::move(value));
+	}
+
+	//O(1) amortised
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	void MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::put(TKey&& key, TValue&& value)
+	{
+		mapped_.remove(key);
+		memory_.put(std::move(key), std::move(value));
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	TValue MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get(const TKey& key)
+	{
+		std::optional<TValue> value = copy_value(key);
+		if (!value)
+		{
+			throw std::exception("key not in lru");
+		}
+		return std::move(*value);
+	}
+
+	//O(1) in memory
+	//O(value size) when promoted from the mapped tier
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	bool MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::try_get(const TKey& key, TValue& out_value)
+	{
+		std::optional<TValue> value = copy_value(key);
+		if (!value)
+		{
+			return false;
+		}
+		out_value = std::move(*value);
+		return true;
+	}
+
+	//O(1) in memory
+	//O(value size) when promoted from the mapped tier
+	//the memory tier counts a promotion as a miss followed by a put
+	//a promoted value is put in memory before it leaves the mapped tier, so a put that throws loses nothing,
+	//and it is only dropped from the mapped tier if memory kept it rather than evicting it straight back down
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	std::optional<TValue> MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::copy_value(const TKey& key)
+	{
+		TValue* value = memory_.try_get(key);
+		if (value != nullptr)
+		{
+			return std::optional<TValue>(*value);
+		}
+		std::optional<TValue> promoted = mapped_.read(key);
+		if (!promoted)
+		{
+			return std::nullopt;
+		}
+		memory_.put(key, *promoted);
+		++promotions_;
+		if (memory_.contains(key))
+		{
+			mapped_.remove(key);
+		}
+		return promoted;
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	void MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::remove(const TKey& key)
+	{
+		if (!mapped_.remove(key))
+		{
+			memory_.remove(key);
+		}
+	}
+
+	//O(1)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	bool MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::contains(const TKey& key)
+	{
+		return memory_.contains(key) || mapped_.contains(key);
+	}
+
+	//O(n)
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	void MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::clear()
+	{
+		memory_.clear();
+		mapped_.clear();
+	}
+
+	//O(1)
+	//of the memory tier
+	template <typename TKey, typename TValue, template<typename> class TPolicy, typename TStats, typename TValueSerializer>
+	CacheStatsSnapshot MyTieredLruCache<TKey, TValue, TPolicy, TStats, TValueSerializer>::get_stats() const
+	{
+		return memory_.get_stats();
+	}
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace ds
+{
+	//hierarchical timing wheel, four levels of 64 buckets where a level n bucket spans 64^n ticks
+	//scheduling and cancelling are O(1), advancing only visits the buckets that come due and entries
+	//on an upper level cascade down into finer buckets whenever the level below wraps around
+	//
+	//TEntry derives from Hook so the timer links live inside the entry, the wheel doesn't own entries
+	template<typename TEntry>
+	class MyTimingWheel
+	{
+	public:
+		struct Hook
+		{
+			TEntry* timer_next = nullptr;
+			TEntry* timer_previous = nullptr;
+			uint64_t expires_at = 0; //0 while not scheduled
+			uint16_t timer_bucket = 0;
+		};
+
+	private:
+		static constexpr int BITS_PER_LEVEL = 6;
+		static constexpr uint64_t BUCKETS_PER_LEVEL = 1 << BITS_PER_LEVEL;
+		static constexpr int LEVELS = 4;
+
+		std::array<TEntry*, BUCKETS_PER_LEVEL * LEVELS> buckets_{};
+		std::array<size_t, LEVELS> level_counts_{};
+		uint64_t current_ = 0;
+		size_t count_ = 0;
+
+		void link(TEntry& entry, uint64_t earliest);
+		void unlink(TEntry& entry);
+		void cascade(int level);
+
+	public:
+		void schedule(TEntry& entry, uint64_t expires_at);
+		void cancel(TEntry& entry);
+		template<typename TOnExpired>
+		void advance(uint64_t now, TOnExpired on_expired);
+
+		uint64_t get_current() const;
+		size_t size() const;
+		bool is_empty() const;
+		void clear();
+	};
+
+	//O(1)
+	//picks the finest level whose buckets reach the expiry, anything past the top level waits in its
+	//furthest bucket and is placed again when that bucket cascades
+	//earliest is the first tick the entry may be placed at, the current tick is only valid while cascading
+	//since its level 0 bucket is about to be visited
+	template <typename TEntry>
+	void MyTimingWheel<TEntry>::link(TEntry& entry, uint64_t earliest)
+	{
+		const uint64_t expires_at = std::max(entry.expires_at, earliest);
+		int level = 0;
+		while (level < LEVELS - 1 && (expires_at >> (BITS_PER_LEVEL * level)) - (current_ >> (BITS_PER_LEVEL * level)) >= BUCKETS_PER_LEVEL)
+		{
+			++level;
+		}
+		const uint64_t current_block = current_ >> (BITS_PER_LEVEL * level);
+		const uint64_t block = std::min(expires_at >> (BITS_PER_LEVEL * level), current_block + BUCKETS_PER_LEVEL - 1);
+		const size_t bucket = level * BUCKETS_PER_LEVEL + (block & (BUCKETS_PER_LEVEL - 1));
+
+		entry.timer_bucket = static_cast<uint16_t>(bucket);
+		entry.timer_previous = nullptr;
+		entry.timer_next = buckets_[bucket];
+		if (buckets_[bucket] != nullptr)
+		{
+			buckets_[bucket]->timer_previous = &entry;
+		}
+		buckets_[bucket] = &entry;
+		++level_counts_[level];
+		++count_;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void MyTimingWheel<TEntry>::unlink(TEntry& entry)
+	{
+		if (entry.timer_previous != nullptr)
+		{
+			entry.timer_previous->timer_next = entry.timer_next;
+		}
+		else
+		{
+			buckets_[entry.timer_bucket] = entry.timer_next;
+		}
+		if (entry.timer_next != nullptr)
+		{
+			entry.timer_next->timer_previous = entry.timer_previous;
+		}
+		entry.timer_next = nullptr;
+		entry.timer_previous = nullptr;
+		--level_counts_[entry.timer_bucket / BUCKETS_PER_LEVEL];
+		--count_;
+	}
+
+	//O(entries in the bucket)
+	template <typename TEntry>
+	void MyTimingWheel<TEntry>::cascade(int level)
+	{
+		const size_t bucket = level * BUCKETS_PER_LEVEL + ((current_ >> (BITS_PER_LEVEL * level)) & (BUCKETS_PER_LEVEL - 1));
+		while (buckets_[bucket] != nullptr)
+		{
+			TEntry& entry = *buckets_[bucket];
+			unlink(entry);
+			link(entry, current_);
+		}
+	}
+
+	//O(1)
+	//expires_at is in ticks, an expiry that has already passed fires on the next advance
+	template <typename TEntry>
+	void MyTimingWheel<TEntry>::schedule(TEntry& entry, uint64_t expires_at)
+	{
+		if (entry.expires_at != 0)
+		{
+			unlink(entry);
+		}
+		entry.expires_at = std::max<uint64_t>(expires_at, 1);
+		link(entry, current_ + 1);
+	}
+
+	//O(1)
+	template <typename TEntry>
+	void MyTimingWheel<TEntry>::cancel(TEntry& entry)
+	{
+		if (entry.expires_at == 0)
+		{
+			return;
+		}
+		unlink(entry);
+		entry.expires_at = 0;
+	}
+
+	//O(expired + cascaded) amortised, stretches where the finer levels are empty are skipped
+	//on_expired(entry) is called with the entry already taken out of the wheel
+	template <typename TEntry>
+	template <typename TOnExpired>
+	void MyTimingWheel<TEntry>::advance(uint64_t now, TOnExpired on_expired)
+	{
+		while (current_ < now)
+		{
+			if (count_ == 0)
+			{
+				current_ = now;
+				return;
+			}
+
+			uint64_t next = current_ + 1;
+			for (int level = 0; level < LEVELS - 1 && level_counts_[level] == 0; level++)
+			{
+				const uint64_t span = 1ull << (BITS_PER_LEVEL * (level + 1));
+				next = (current_ | (span - 1)) + 1;
+			}
+			current_ = std::min(next, now);
+
+			for (int level = LEVELS - 1; level > 0; level--)
+			{
+				if ((current_ & ((1ull << (BITS_PER_LEVEL * level)) - 1)) == 0)
+				{
+					cascade(level);
+				}
+			}
+
+			const size_t bucket = current_ & (BUCKETS_PER_LEVEL - 1);
+			while (buckets_[bucket] != nullptr)
+			{
+				TEntry& entry = *buckets_[bucket];
+				unlink(entry);
+				if (entry.expires_at <= current_)
+				{
+					entry.expires_at = 0;
+					on_expired(entry);
+				}
+				else
+				{
+					link(entry, current_ + 1);
+				}
+			}
+		}
+	}
+
+	//O(1)
+	template <typename TEntry>
+	uint64_t MyTimingWheel<TEntry>::get_current() const
+	{
+		return current_;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	size_t MyTimingWheel<TEntry>::size() const
+	{
+		return count_;
+	}
+
+	//O(1)
+	template <typename TEntry>
+	bool MyTimingWheel<TEntry>::is_empty() const
+	{
+		return count_ == 0;
+	}
+
+	//O(buckets)
+	//the entries are owned elsewhere, this only forgets them
+	template <typename TEntry>
+	void MyTimingWheel<TEntry>::clear()
+	{
+		buckets_.fill(nullptr);
+		level_counts_.fill(0);
+		count_ = 0;
+	}
+}
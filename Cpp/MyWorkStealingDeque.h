@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ds
+{
+	//a Chase-Lev work stealing deque, in the C11 form of Le, Pop, Cohen and Zappa Nardelli
+	//one owner thread pushes and pops at the bottom, like MyArrayDeque's last end, while any number of thieves steal
+	//from the top, the owner only pays for a compare exchange when it and a thief both want the last item
+	//the items sit in a power of two ring indexed with a mask like MyArrayDeque's, top_ and bottom_ only ever grow
+	//apart from the owner's pop briefly lowering bottom_, so bottom_ - top_ is the count
+	//
+	//a full ring is copied into one twice the size, the old ring is kept until the deque goes since a thief may still
+	//be reading from it, which costs at most the size of the final ring again
+	//the slots are atomics so a thief can read one the owner is overwriting, so Type has to be trivially copyable,
+	//a pointer to the real work in practice
+	template<typename Type>
+	class MyWorkStealingDeque
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "work stealing deque items are copied racily, use pointers");
+
+		struct Ring
+		{
+			int64_t mask;
+			std::unique_ptr<std::atomic<Type>[]> slots;
+
+			explicit Ring(int64_t capacity) : mask(capacity - 1), slots(new std::atomic<Type>[capacity]) {}
+			Type get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+			void put(int64_t index, Type item) { slots[index & mask].store(item, std::memory_order_relaxed); }
+		};
+
+		alignas(64) std::atomic<int64_t> top_ = 0;
+		alignas(64) std::atomic<int64_t> bottom_ = 0;
+		std::atomic<Ring*> ring_;
+		std::vector<std::unique_ptr<Ring>> rings_; //the current ring and every one it outgrew, owner only
+
+		Ring* grow(Ring* ring, int64_t top, int64_t bottom);
+
+	public:
+		explicit MyWorkStealingDeque(int64_t capacity = 64);
+		MyWorkStealingDeque(const MyWorkStealingDeque&) = delete;
+		MyWorkStealingDeque& operator=(const MyWorkStealingDeque&) = delete;
+
+		//owner only
+		void push(Type item);
+		bool try_pop(Type& out_item);
+
+		//any thread
+		bool try_steal(Type& out_item);
+		[[nodiscard]] int64_t get_count() const;
+	};
+
+	//O(capacity)
+	//capacity is rounded up to a power of two
+	template <typename Type>
+	MyWorkStealingDeque<Type>::MyWorkStealingDeque(int64_t capacity)
+	{
+		int64_t rounded = 1;
+		while (rounded < capacity)
+		{
+			rounded *= 2;
+		}
+		rings_.push_back(std::make_unique<Ring>(rounded));
+		ring_.store(rings_.back().get(), std::memory_order_relaxed);
+	}
+
+	//O(n)
+	//copies the live items into a ring twice the size at the same indices and publishes it
+	template <typename Type>
+	typename MyWorkStealingDeque<Type>::Ring* MyWorkStealingDeque<Type>::grow(Ring* ring, int64_t top, int64_t bottom)
+	{
+		auto grown = std::make_unique<Ring>((ring->mask + 1) * 2);
+		for (int64_t index = top; index < bottom; index++)
+		{
+			grown->put(index, ring->get(index));
+		}
+		Ring* published = grown.get();
+		rings_.push_back(std::move(grown));
+		ring_.store(published, std::memory_order_release);
+		return published;
+	}
+
+	//O(1) amortised
+	template <typename Type>
+	void MyWorkStealingDeque<Type>::push(Type item)
+	{
+		const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+		const int64_t top = top_.load(std::memory_order_acquire);
+		Ring* ring = ring_.load(std::memory_order_relaxed);
+		if (bottom - top > ring->mask)
+		{
+			ring = grow(ring, top, bottom);
+		}
+		ring->put(bottom, item);
+		bottom_.store(bottom + 1, std::memory_order_release); //publishes the item, a release store is a plain store on x86
+	}
+
+	//O(1)
+	//the newest item, false when empty or a thief won the last one
+	//bottom_ is lowered before top_ is read, with a full fence between, so a thief racing for the same last item
+	//either sees the lowered bottom_ and backs off or is seen here, and then the compare exchange on top_ decides
+	template <typename Type>
+	bool MyWorkStealingDeque<Type>::try_pop(Type& out_item)
+	{
+		const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+		Ring* ring = ring_.load(std::memory_order_relaxed);
+		bottom_.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = top_.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			bottom_.store(bottom + 1, std::memory_order_relaxed); //was empty
+			return false;
+		}
+		out_item = ring->get(bottom);
+		if (top < bottom)
+		{
+			return true; //more than one item, no thief can reach this one
+		}
+		const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return won;
+	}
+
+	//O(1)
+	//the oldest item, false when empty or another thread got there first, a thief is expected to move on and retry later
+	template <typename Type>
+	bool MyWorkStealingDeque<Type>::try_steal(Type& out_item)
+	{
+		int64_t top = top_.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = bottom_.load(std::memory_order_acquire);
+		if (top >= bottom)
+		{
+			return false;
+		}
+		const Type item = ring_.load(std::memory_order_acquire)->get(top);
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return false;
+		}
+		out_item = item;
+		return true;
+	}
+
+	//O(1)
+	//only a snapshot while other threads run
+	template <typename Type>
+	int64_t MyWorkStealingDeque<Type>::get_count() const
+	{
+		const int64_t bottom = bottom_.load(std::memory_order_acquire);
+		const int64_t top = top_.load(std::memory_order_acquire);
+		return bottom > top ? bottom - top : 0;
+	}
+}